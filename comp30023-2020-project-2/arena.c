@@ -0,0 +1,48 @@
+/* Bump allocator for records that all share the lifetime of one simulation */
+#include "arena.h"
+
+
+// Create a new empty Arena and return a pointer to it
+Arena *new_arena() {
+    Arena *arena = (Arena*)malloc(sizeof(Arena));
+    arena->blocks = NULL;
+    return arena;
+}
+
+// Returns size bytes that live until the arena is freed
+void *arena_alloc(Arena *arena, size_t size) {
+    ArenaBlock *block = arena->blocks;
+    size_t capacity;
+    void *allocated;
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if ((block == NULL) || (block->used + size > block->capacity)) {
+        // Oversized requests get a block of their own
+        capacity = (size > ARENA_BLOCK_SIZE) ? size : ARENA_BLOCK_SIZE;
+        block = (ArenaBlock*)malloc(sizeof(ArenaBlock) + capacity);
+        if (block == NULL) {
+            fprintf(stderr, "Arena could not allocate %zu bytes\n", capacity);
+            exit(1);
+        }
+        block->capacity = capacity;
+        block->used = 0;
+        block->next = arena->blocks;
+        arena->blocks = block;
+    }
+    allocated = block->data + block->used;
+    block->used += size;
+    return allocated;
+}
+
+// Frees everything allocated from the arena in one go
+void free_arena(Arena *arena) {
+    ArenaBlock *next_block;
+    ArenaBlock *block = arena->blocks;
+
+    while (block != NULL) {
+        next_block = block->next;
+        free(block);
+        block = next_block;
+    }
+    free(arena);
+}
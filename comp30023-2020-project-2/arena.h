@@ -0,0 +1,32 @@
+#ifndef ARENA_H
+#define ARENA_H
+#define ARENA_BLOCK_SIZE (1 << 20)
+#define ARENA_ALIGN 8
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct arena_block ArenaBlock;
+typedef struct arena Arena;
+
+struct arena_block {
+    ArenaBlock *next;
+    size_t capacity;
+    size_t used;
+    char data[];
+};
+
+struct arena {
+    ArenaBlock *blocks; // Most recent block first, allocations come from it
+};
+
+// Create a new empty Arena and return a pointer to it
+Arena *new_arena();
+
+// Returns size bytes that live until the arena is freed
+void *arena_alloc(Arena *arena, size_t size);
+
+// Frees everything allocated from the arena in one go
+void free_arena(Arena *arena);
+
+#endif
@@ -0,0 +1,82 @@
+/* Runs a command and writes its wall time in seconds, peak resident set size
+   in KB and how it ended ("ok", "failed" or "timeout") to a report file, as
+   one line. The command is killed once it runs past the time limit.
+   Usage: bench-run [-t seconds] <report file> <command> [arguments...] */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+static pid_t child;
+static volatile sig_atomic_t timed_out = 0;
+
+
+static double now_s() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec/1e9;
+}
+
+static void time_limit(int signal) {
+    (void)signal;
+    timed_out = 1;
+    kill(child, SIGKILL);
+}
+
+int main(int argc, char **argv)
+{
+    int opt, status;
+    unsigned limit = 0;
+    double start, seconds;
+    struct rusage usage;
+    FILE *report;
+
+    while ((opt = getopt(argc, argv, "+t:")) != -1) {
+        if (opt == 't') {
+            limit = atoi(optarg);
+        } else {
+            optind = argc;
+            break;
+        }
+    }
+    if (argc - optind < 2) {
+        fprintf(stderr, "Usage: %s [-t seconds] <report file> <command> [arguments...]\n",
+                argv[0]);
+        exit(1);
+    }
+
+    start = now_s();
+    child = fork();
+    if (child < 0) {
+        perror("fork");
+        exit(1);
+    }
+    if (child == 0) {
+        execvp(argv[optind + 1], argv + optind + 1);
+        perror(argv[optind + 1]);
+        _exit(127);
+    }
+    signal(SIGALRM, time_limit);
+    alarm(limit);
+    while (wait4(child, &status, 0, &usage) < 0) {
+        // Interrupted by the alarm, the killed child is still to be reaped
+    }
+    seconds = now_s() - start;
+
+    report = fopen(argv[optind], "w");
+    if (report == NULL) {
+        perror(argv[optind]);
+        exit(1);
+    }
+    // Linux reports ru_maxrss in KB
+    fprintf(report, "%.3f %ld %s\n", seconds, usage.ru_maxrss,
+            timed_out ? "timeout" :
+            ((WIFEXITED(status) && (WEXITSTATUS(status) == 0)) ? "ok" : "failed"));
+    fclose(report);
+    return 0;
+}
@@ -0,0 +1,165 @@
+/* Compares the ring buffer Deque against the doubly linked list it replaced on
+   the access patterns of the scheduler: arrivals, round robin rotation and the
+   full queue walks done by fair_alloc(). */
+#include <time.h>
+#include "../process-deque.h"
+
+#define QUEUED 1000000
+#define WALKS 20
+
+typedef struct list_node ListNode;
+
+// Replica of the old list node, one malloc per enqueue
+struct list_node {
+    Process *process;
+    ListNode *prev;
+    ListNode *next;
+};
+
+typedef struct {
+    ListNode *head;
+    ListNode *foot;
+    int size;
+} List;
+
+
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1e3 + ts.tv_nsec/1e6;
+}
+
+static void list_append(List *list, Process *process) {
+    ListNode *node = (ListNode*)malloc(sizeof(ListNode));
+    node->process = process;
+    node->next = NULL;
+    node->prev = list->foot;
+    if (list->foot != NULL) {
+        list->foot->next = node;
+    } else {
+        list->head = node;
+    }
+    list->foot = node;
+    list->size += 1;
+}
+
+static Process *list_pop(List *list) {
+    ListNode *node = list->head;
+    Process *process = node->process;
+    list->head = node->next;
+    if (list->head != NULL) {
+        list->head->prev = NULL;
+    } else {
+        list->foot = NULL;
+    }
+    list->size -= 1;
+    free(node);
+    return process;
+}
+
+// Relinks the list's nodes in a random address order, keeping the process order
+static void scatter_list(List *list) {
+    int i, j;
+    ListNode *node, *temp;
+    ListNode **nodes = (ListNode**)malloc(list->size*sizeof(ListNode*));
+    Process **order = (Process**)malloc(list->size*sizeof(Process*));
+
+    for (i=0, node=list->head; node!=NULL; node=node->next, i++) {
+        nodes[i] = node;
+        order[i] = node->process;
+    }
+    for (i=list->size-1; i>0; i--) {
+        j = rand() % (i + 1);
+        temp = nodes[i];
+        nodes[i] = nodes[j];
+        nodes[j] = temp;
+    }
+    for (i=0; i<list->size; i++) {
+        nodes[i]->process = order[i];
+        nodes[i]->prev = (i > 0) ? nodes[i-1] : NULL;
+        nodes[i]->next = (i < list->size-1) ? nodes[i+1] : NULL;
+    }
+    list->head = nodes[0];
+    list->foot = nodes[list->size-1];
+    free(nodes);
+    free(order);
+}
+
+int main(int argc, char **argv)
+{
+    int i, walk;
+    long total;
+    double start, append_ms, rotate_ms, walk_ms, drain_ms;
+    Process *processes = (Process*)calloc(QUEUED, sizeof(Process));
+    Deque *deque = new_deque();
+    List list = {NULL, NULL, 0};
+    ListNode *node;
+
+    for (i=0; i<QUEUED; i++) {
+        processes[i].pid = i;
+        processes[i].remaining_time = i % 97;
+    }
+    srand(30023);
+
+    printf("structure, append ms, rotate ms, walk ms, drain ms\n");
+    // Ring first, freeing a million scattered list nodes skews later mallocs
+    /* Ring buffer */
+    start = now_ms();
+    for (i=0; i<QUEUED; i++) {
+        deque_append(deque, &processes[i]);
+    }
+    append_ms = now_ms() - start;
+    start = now_ms();
+    for (i=0; i<QUEUED; i++) {
+        deque_append(deque, deque_pop(deque));
+    }
+    rotate_ms = now_ms() - start;
+    start = now_ms();
+    total = 0;
+    for (walk=0; walk<WALKS; walk++) {
+        for (i=0; i<deque->size; i++) {
+            total += deque_get(deque, i)->remaining_time;
+        }
+    }
+    walk_ms = (now_ms() - start) / WALKS;
+    start = now_ms();
+    while (!deque_null(deque)) {
+        deque_pop(deque);
+    }
+    drain_ms = now_ms() - start;
+    printf("ring, %.2f, %.2f, %.2f, %.2f (checksum %ld)\n",
+           append_ms, rotate_ms, walk_ms, drain_ms, total);
+
+    /* Linked list */
+    start = now_ms();
+    for (i=0; i<QUEUED; i++) {
+        list_append(&list, &processes[i]);
+    }
+    append_ms = now_ms() - start;
+    start = now_ms();
+    for (i=0; i<QUEUED; i++) {
+        list_append(&list, list_pop(&list));
+    }
+    rotate_ms = now_ms() - start;
+    // A long run leaves queue order unrelated to node addresses, shuffle to match
+    scatter_list(&list);
+    start = now_ms();
+    total = 0;
+    for (walk=0; walk<WALKS; walk++) {
+        for (node=list.head; node!=NULL; node=node->next) {
+            total += node->process->remaining_time;
+        }
+    }
+    walk_ms = (now_ms() - start) / WALKS;
+    start = now_ms();
+    while (list.size > 0) {
+        list_pop(&list);
+    }
+    drain_ms = now_ms() - start;
+    printf("list, %.2f, %.2f, %.2f, %.2f (checksum %ld)\n",
+           append_ms, rotate_ms, walk_ms, drain_ms, total);
+
+    free_deque(deque);
+    free(processes);
+    return 0;
+}
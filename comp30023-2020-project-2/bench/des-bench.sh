@@ -0,0 +1,60 @@
+#!/bin/sh
+# Measures what reading arrivals ahead (--read-ahead) and rendering the event
+# log on threads (--log-threads) save against a single threaded run.
+# Usage: bench/des-bench.sh [processes] [max log threads] [scheduler arguments...]
+# Run from the project directory after make. Every run's output is compared
+# with the single threaded one, and the wall time and speedup are printed per run.
+
+PROCESSES=${1:-2000000}
+MAX_THREADS=${2:-$(nproc)}
+shift 2 2>/dev/null
+ARGS=${*:-"-a rr -m p -s 1000 -q3"}
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+# Fixed seed, so every run of the benchmark sees the same trace
+awk -v n="$PROCESSES" 'BEGIN {
+    srand(7); t = 0
+    for (i = 1; i <= n; i++) {
+        t += int(rand()*5)
+        printf "%d %d %d %d\n", t, i, 8*2^int(rand()*4), 1+int(rand()*6)
+    }
+}' > "$DIR/trace.txt"
+
+# Wall time of one run over the text trace in seconds
+run() {
+    start=$(date +%s.%N)
+    ./scheduler -f "$DIR/trace.txt" $ARGS --stream "$@" > "$DIR/out"
+    end=$(date +%s.%N)
+    awk -v s="$start" -v e="$end" 'BEGIN { printf "%.3f", e - s }'
+}
+
+# Prints one row, once its output matches the single threaded one
+row() {
+    name=$1
+    shift
+    seconds=$(run "$@")
+    if ! cmp -s "$DIR/out" "$DIR/base"; then
+        echo "Output with $* differs from the single threaded one" >&2
+        exit 1
+    fi
+    echo "$name,$seconds,$(awk -v s="$base" -v p="$seconds" 'BEGIN { printf "%.2f", s / p }')"
+}
+
+echo "run,seconds,speedup"
+
+# Without the log only the simulation and the reading of its trace are left
+base=$(run --quiet)
+cp "$DIR/out" "$DIR/base"
+echo "quiet,$base,1.00"
+row "quiet read-ahead" --quiet --read-ahead
+
+base=$(run)
+cp "$DIR/out" "$DIR/base"
+echo "log,$base,1.00"
+row "log read-ahead" --read-ahead
+threads=2
+while [ "$threads" -le "$MAX_THREADS" ] || [ "$threads" -eq 2 ]; do
+    row "log read-ahead $threads log threads" --read-ahead --log-threads "$threads"
+    threads=$((threads * 2))
+done
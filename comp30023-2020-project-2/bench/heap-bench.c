@@ -0,0 +1,61 @@
+/* Times shortest first scheduling decisions on the job time heap for growing
+   ready queue sizes. Cost per decision should grow with log2(n), not n. */
+#include <time.h>
+#include "../process-heap.h"
+#include "../arena.h"
+
+#define MIN_QUEUE 1000
+#define MAX_QUEUE 1000000
+
+
+static double now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+static Process *bench_process(Arena *arena, int pid, int job_time) {
+    Process *process = (Process*)arena_alloc(arena, sizeof(Process));
+    memset(process, 0, sizeof(Process));
+    process->pid = pid;
+    process->job_time = job_time;
+    process->remaining_time = job_time;
+    return process;
+}
+
+int main(int argc, char **argv)
+{
+    int n, i, log_n;
+    double start, per_decision;
+    Deque *arrived;
+    Heap *ready;
+    Arena *arena;
+
+    srand(30023);
+    printf("queued, ns/decision, ns/decision/log2(queued)\n");
+    for (n=MIN_QUEUE; n<=MAX_QUEUE; n*=10) {
+        arena = new_arena();
+        arrived = new_deque();
+        ready = new_heap(arrived);
+        for (i=0; i<n; i++) {
+            deque_append(arrived, bench_process(arena, i, rand() % 10000 + 1));
+        }
+        heap_fill(ready);
+
+        // Each decision pops the shortest job and admits a new arrival
+        start = now_ns();
+        for (i=0; i<n; i++) {
+            heap_pop(ready);
+            deque_append(arrived, bench_process(arena, n+i, rand() % 10000 + 1));
+            heap_fill(ready);
+        }
+        per_decision = (now_ns() - start) / n;
+
+        for (log_n=0; (1 << log_n) < n; log_n++);
+        printf("%d, %.1f, %.2f\n", n, per_decision, per_decision / log_n);
+        free_heap(ready);
+        free_deque(arrived);
+        free_arena(arena);
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+/* Times load_trace() on a generated trace, 10 million lines by default, as
+   text and after conversion to the binary format.
+   Usage: load-bench [lines] [trace file to write] */
+#include <time.h>
+#include <limits.h>
+#include "../trace.h"
+
+#define DEFAULT_LINES 10000000
+#define DEFAULT_PATH "/tmp/load-bench-trace.txt"
+
+
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1e3 + ts.tv_nsec/1e6;
+}
+
+int main(int argc, char **argv)
+{
+    long i, lines = (argc > 1) ? atol(argv[1]) : DEFAULT_LINES;
+    char *path = (argc > 2) ? argv[2] : DEFAULT_PATH;
+    int arrival = 0;
+    double start, text_ms, binary_ms;
+    char binary_path[PATH_MAX];
+    FILE *trace = fopen(path, "w");
+    Arena *arena;
+    Trace *process_list;
+
+    if (trace == NULL) {
+        perror(path);
+        return 1;
+    }
+    srand(30023);
+    for (i=0; i<lines; i++) {
+        arrival += rand() % 3;
+        fprintf(trace, "%d %ld %d %d\r\n", arrival, i + 1, 4*(rand() % 64 + 1),
+                rand() % 100 + 1);
+    }
+    fclose(trace);
+
+    arena = new_arena();
+    start = now_ms();
+    process_list = load_trace(path, arena);
+    text_ms = now_ms() - start;
+    snprintf(binary_path, sizeof(binary_path), "%s.bin", path);
+    write_trace(process_list, binary_path);
+    free_trace(process_list);
+
+    start = now_ms();
+    process_list = load_trace(binary_path, arena);
+    binary_ms = now_ms() - start;
+
+    printf("lines, text load ms, text ns/line, binary load ms, processes\n");
+    printf("%ld, %.1f, %.1f, %.3f, %d\n", lines, text_ms, text_ms*1e6 / lines,
+           binary_ms, process_list->count);
+
+    free_trace(process_list);
+    free_arena(arena);
+    remove(path);
+    remove(binary_path);
+    return 0;
+}
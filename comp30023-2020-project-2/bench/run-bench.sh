@@ -0,0 +1,67 @@
+#!/bin/sh
+# Runs every scheduling algorithm and memory mode over generated traces of
+# each size and distribution, and writes one CSV row per run with the wall
+# time, events logged, events per second, peak resident set size and status.
+# Usage: bench/run-bench.sh, run from the project directory after make bench
+# builds the tools. Settings come from the environment:
+#   BENCH_SIZES      processes per trace, "1000 10000 100000 1000000 10000000"
+#   BENCH_DISTS      workload-gen distributions, "poisson heavy bursty"
+#   BENCH_POLICIES   scheduling algorithms, "ff rr cs srtf mlfq"
+#   BENCH_MODES      memory modes, "u p v cm clock"
+#   BENCH_TIMEOUT    seconds before a run is killed and marked timeout, 60
+#   BENCH_REPORT     CSV written, bench/report.csv
+#   BENCH_BASELINE   earlier report to compare against, none
+#   BENCH_TOLERANCE  percent slower than the baseline that counts as a regression, 20
+# With a baseline, runs that got slower beyond the tolerance (ignoring runs
+# under 0.05 seconds, which are mostly noise) or stopped finishing are listed
+# and the script exits with 1.
+
+SIZES=${BENCH_SIZES:-"1000 10000 100000 1000000 10000000"}
+DISTS=${BENCH_DISTS:-"poisson heavy bursty"}
+POLICIES=${BENCH_POLICIES:-"ff rr cs srtf mlfq"}
+MODES=${BENCH_MODES:-"u p v cm clock"}
+TIMEOUT=${BENCH_TIMEOUT:-60}
+REPORT=${BENCH_REPORT:-bench/report.csv}
+TOLERANCE=${BENCH_TOLERANCE:-20}
+# Quantum above the largest page fault penalty, so rr and mlfq make progress
+# under v, cm and clock
+ARGS="-s 1024 -q40"
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+echo "processes,distribution,sched,mem,seconds,events,events_per_sec,peak_rss_kb,status" > "$REPORT"
+for size in $SIZES; do
+    for dist in $DISTS; do
+        # Fixed seed, so every run of the benchmark sees the same traces
+        ./bench/workload-gen -n "$size" -d "$dist" -s 30023 > "$DIR/trace.txt" || exit 1
+        ./trace-convert "$DIR/trace.txt" "$DIR/trace.bin" > /dev/null || exit 1
+        rm "$DIR/trace.txt"
+        for sched in $POLICIES; do
+            for mem in $MODES; do
+                events=$(./bench/bench-run -t "$TIMEOUT" "$DIR/result" \
+                         ./scheduler -f "$DIR/trace.bin" -a "$sched" -m "$mem" $ARGS |
+                         grep -c '^[0-9]')
+                read seconds rss status < "$DIR/result"
+                row=$(awk -v s="$seconds" -v e="$events" 'BEGIN {
+                    printf "%s,%d,%.0f", s, e, (s > 0) ? e / s : 0
+                }')
+                echo "$size,$dist,$sched,$mem,$row,$rss,$status" | tee -a "$REPORT"
+            done
+        done
+    done
+done
+
+[ -n "$BENCH_BASELINE" ] || exit 0
+awk -F, -v tolerance="$TOLERANCE" '
+    FNR == 1 { next }
+    { key = $1 "," $2 "," $3 "," $4 }
+    NR == FNR { seconds[key] = $5; status[key] = $9; next }
+    !(key in seconds) { next }
+    status[key] == "ok" && $9 != "ok" {
+        printf "Regression %s: %s, was ok\n", key, $9; failed = 1; next
+    }
+    status[key] == "ok" && $5 >= 0.05 && $5 > seconds[key] * (1 + tolerance / 100) {
+        printf "Regression %s: %.3f seconds, was %.3f\n", key, $5, seconds[key]; failed = 1
+    }
+    END { exit failed }
+' "$BENCH_BASELINE" "$REPORT"
@@ -0,0 +1,146 @@
+/* Writes a seeded synthetic process trace for benchmarking. Arrivals, memory
+   sizes and job times each follow one of three distribution families:
+     poisson  exponential gaps between arrivals, exponential sizes and times
+     heavy    Pareto gaps, sizes and times, so a few values are very large
+     bursty   arrivals in simultaneous bursts, sizes and times mostly small
+              with the occasional large one
+   The same arguments always give the same trace.
+   Usage: workload-gen [-n processes] [-d family] [-a family] [-m family]
+                       [-j family] [-s seed] [-M max memory KB] [-J max job time]
+   -d sets all three families, -a, -m and -j override one each */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <math.h>
+
+#define POISSON 0
+#define HEAVY 1
+#define BURSTY 2
+#define MEAN_GAP 10.0 // Time between arrivals on average, for every family
+#define MEAN_PAGES 8.0
+#define MEAN_JOB 8.0
+#define MEAN_BURST 20.0
+#define PARETO_SHAPE 1.5
+#define KB_PER_PAGE 4
+
+
+// Next value of a splitmix64 generator, the same on every platform unlike rand()
+static uint64_t next_random(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform double in (0, 1]
+static double uniform(uint64_t *state) {
+    return ((next_random(state) >> 11) + 1.0) / 9007199254740992.0;
+}
+
+static double exponential(uint64_t *state, double mean) {
+    return -mean * log(uniform(state));
+}
+
+// Pareto with the given mean, at least mean*(shape-1)/shape
+static double pareto(uint64_t *state, double mean) {
+    double scale = mean * (PARETO_SHAPE - 1) / PARETO_SHAPE;
+    return scale / pow(uniform(state), 1.0 / PARETO_SHAPE);
+}
+
+// Mostly small values with one in ten near the limit
+static double bimodal(uint64_t *state, double mean, double limit) {
+    if (uniform(state) < 0.9) {
+        return 1 + uniform(state) * mean / 2;
+    }
+    return limit / 2 + uniform(state) * limit / 2;
+}
+
+// Returns the family named by name, exits if there is none
+static int family(char *name) {
+    if (!strcmp(name, "poisson")) {
+        return POISSON;
+    }
+    if (!strcmp(name, "heavy")) {
+        return HEAVY;
+    }
+    if (!strcmp(name, "bursty")) {
+        return BURSTY;
+    }
+    fprintf(stderr, "Unknown distribution %s, expected poisson, heavy or bursty\n", name);
+    exit(1);
+}
+
+// Draws a positive value of the family, capped at limit
+static long draw(uint64_t *state, int kind, double mean, long limit) {
+    double value;
+
+    if (kind == POISSON) {
+        value = 1 + exponential(state, mean - 1);
+    } else if (kind == HEAVY) {
+        value = pareto(state, mean);
+    } else {
+        value = bimodal(state, mean, limit);
+    }
+    if (value < 1) {
+        value = 1;
+    }
+    return (value > limit) ? limit : (long)value;
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    int arrivals = POISSON, sizes = POISSON, jobs = POISSON;
+    long i, processes = 1000, max_kb = 128, max_job = 1000, burst_left = 0;
+    double clock = 0;
+    uint64_t state = 30023;
+
+    while ((opt = getopt(argc, argv, "n:d:a:m:j:s:M:J:")) != -1) {
+        if (opt == 'n') {
+            processes = atol(optarg);
+        } else if (opt == 'd') {
+            arrivals = sizes = jobs = family(optarg);
+        } else if (opt == 'a') {
+            arrivals = family(optarg);
+        } else if (opt == 'm') {
+            sizes = family(optarg);
+        } else if (opt == 'j') {
+            jobs = family(optarg);
+        } else if (opt == 's') {
+            state = strtoull(optarg, NULL, 10);
+        } else if (opt == 'M') {
+            max_kb = atol(optarg);
+        } else if (opt == 'J') {
+            max_job = atol(optarg);
+        } else {
+            fprintf(stderr, "Usage: %s [-n processes] [-d family] [-a family] [-m family] "
+                    "[-j family] [-s seed] [-M max memory KB] [-J max job time]\n", argv[0]);
+            exit(1);
+        }
+    }
+    if ((processes < 0) || (max_kb < KB_PER_PAGE) || (max_job < 1)) {
+        fprintf(stderr, "Processes can't be negative, nor memory below a page or jobs below 1\n");
+        exit(1);
+    }
+
+    for (i=0; i<processes; i++) {
+        // Every family arrives MEAN_GAP apart on average
+        if (arrivals == POISSON) {
+            clock += exponential(&state, MEAN_GAP);
+        } else if (arrivals == HEAVY) {
+            clock += pareto(&state, MEAN_GAP);
+        } else if (burst_left > 0) {
+            burst_left--;
+        } else {
+            burst_left = (long)exponential(&state, MEAN_BURST - 1);
+            clock += exponential(&state, MEAN_GAP * (burst_left + 1));
+        }
+        printf("%ld %ld %ld %ld\n", (long)clock, i + 1,
+               KB_PER_PAGE * draw(&state, sizes, MEAN_PAGES, max_kb / KB_PER_PAGE),
+               draw(&state, jobs, MEAN_JOB, max_job));
+    }
+    return 0;
+}
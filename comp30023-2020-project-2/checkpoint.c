@@ -0,0 +1,422 @@
+/* Snapshots of a single core simulation, so long runs can be resumed or branched */
+#include "checkpoint.h"
+
+
+typedef struct indexed_process {
+    Process *process;
+    int32_t index;
+} IndexedProcess;
+
+
+// Orders processes by address, so the position of a resident can be looked up
+static int address_comp(const void *first, const void *second) {
+    const Process *x = ((const IndexedProcess*)first)->process;
+    const Process *y = ((const IndexedProcess*)second)->process;
+
+    return (x > y) - (x < y);
+}
+
+// Writes size bytes to a snapshot, keeping track of where the next ones go
+static void put(FILE *output, uint64_t *offset, const void *data, size_t size) {
+    if (size > 0) {
+        fwrite(data, 1, size, output);
+    }
+    *offset += size;
+}
+
+// Pads a snapshot to the next section boundary and returns the offset reached
+static uint64_t align(FILE *output, uint64_t *offset) {
+    char padding[SNAPSHOT_ALIGN] = {0};
+
+    put(output, offset, padding, (SNAPSHOT_ALIGN - *offset % SNAPSHOT_ALIGN) % SNAPSHOT_ALIGN);
+    return *offset;
+}
+
+// Checks whether a simulation starts from a snapshot, checkpoint may be NULL
+int checkpoint_restoring(Checkpoint *checkpoint) {
+    return (checkpoint != NULL) && (checkpoint->restore_file != NULL);
+}
+
+// Checks whether a simulation at clock should be saved now, checkpoint may be NULL
+int checkpoint_due(Checkpoint *checkpoint, int clock) {
+    return (checkpoint != NULL) && (checkpoint->save_file != NULL) && (!checkpoint->saved) &&
+           (clock >= checkpoint->save_at);
+}
+
+/* Writes a snapshot of a simulation at clock to the checkpoint's save file.
+   queues hold every arrived process that hasn't finished, heap orders the
+   first of them and may be NULL, and next_boost is only used by mlfq */
+void save_checkpoint(Checkpoint *checkpoint, int clock, Trace *trace, Deque **queues,
+                     int num_queues, Heap *heap, long next_boost, Memory *memory,
+                     Statistics *stats) {
+    int i, q, size;
+    int32_t value;
+    int64_t total;
+    uint64_t offset = 0;
+    SnapshotHeader header;
+    SnapshotProcess record;
+    SnapshotMemory saved_memory;
+    SnapshotStats saved_stats;
+    IndexedProcess *table, key, *found;
+    Process *process;
+    FILE *output = fopen(checkpoint->save_file, "wb");
+
+    if (output == NULL) {
+        fprintf(stderr, "Could not open %s: %s\n", checkpoint->save_file, strerror(errno));
+        exit(1);
+    }
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN);
+    header.version = SNAPSHOT_VERSION;
+    header.header_size = sizeof(header);
+    strncpy(header.sched_alg, checkpoint->sched_alg, SNAPSHOT_NAME - 1);
+    strncpy(header.mem_alloc, checkpoint->mem_alloc, SNAPSHOT_NAME - 1);
+    header.clock = clock;
+    header.trace_count = trace->count;
+    header.trace_next = trace->next;
+    header.next_boost = next_boost;
+    header.num_queues = num_queues;
+    header.heap_key = (heap != NULL) ? heap->key : -1;
+    if (memory->referenced != NULL) {
+        header.flags |= SNAPSHOT_HAS_REFERENCES;
+    }
+    if (memory->block_order != NULL) {
+        header.flags |= SNAPSHOT_HAS_BUDDY;
+    }
+    if (stats->histograms[HIST_TURNAROUND] != NULL) {
+        header.flags |= SNAPSHOT_HAS_HISTOGRAMS;
+    }
+    for (q=0; q<num_queues; q++) {
+        header.num_processes += deque_size(queues[q]);
+    }
+    // The real header goes in once every offset is known
+    put(output, &offset, &header, sizeof(header));
+
+    // Processes are numbered in queue order
+    table = (IndexedProcess*)malloc((header.num_processes + 1)*sizeof(IndexedProcess));
+    header.processes_offset = align(output, &offset);
+    for (q=0; q<num_queues; q++) {
+        for (i=0; i<deque_size(queues[q]); i++) {
+            process = deque_get(queues[q], i);
+            record.arrival_time = process->arrival_time;
+            record.pid = process->pid;
+            record.mem_req = process->mem_req;
+            record.job_time = process->job_time;
+            record.remaining_time = process->remaining_time;
+            record.pages_used = process->pages_used;
+            record.arrival_order = process->arrival_order;
+            record.next_reference = process->next_reference;
+            put(output, &offset, &record, sizeof(record));
+        }
+    }
+    header.pages_offset = align(output, &offset);
+    size = 0;
+    for (q=0; q<num_queues; q++) {
+        for (i=0; i<deque_size(queues[q]); i++) {
+            process = deque_get(queues[q], i);
+            table[size].process = process;
+            table[size].index = size;
+            size++;
+            put(output, &offset, process->mem_index + process->mem_start,
+                process->pages_used*sizeof(int32_t));
+            header.num_pages += process->pages_used;
+        }
+    }
+    header.queues_offset = align(output, &offset);
+    for (q=0; q<num_queues; q++) {
+        value = deque_size(queues[q]);
+        put(output, &offset, &value, sizeof(value));
+    }
+    for (q=0; q<num_queues; q++) {
+        value = ((q == 0) && (heap != NULL)) ? heap->size : 0;
+        put(output, &offset, &value, sizeof(value));
+    }
+
+    // Residents are written as their process numbers
+    qsort(table, size, sizeof(IndexedProcess), address_comp);
+    header.resident_offset = align(output, &offset);
+    for (process = memory->least_recent; process != NULL; process = process->next_resident) {
+        key.process = process;
+        found = (IndexedProcess*)bsearch(&key, table, size, sizeof(IndexedProcess),
+                                         address_comp);
+        if (found == NULL) {
+            fprintf(stderr, "Resident process %d is in no queue, can't be saved\n", process->pid);
+            exit(1);
+        }
+        put(output, &offset, &found->index, sizeof(found->index));
+        header.num_resident++;
+    }
+    free(table);
+
+    header.memory_offset = align(output, &offset);
+    memset(&saved_memory, 0, sizeof(saved_memory));
+    saved_memory.total_pages = memory->total_pages;
+    saved_memory.empty_pages = memory->empty_pages;
+    saved_memory.first_free = memory->first_free;
+    saved_memory.hand = memory->hand;
+    saved_memory.mem_usage = memory->mem_usage;
+    saved_memory.total_processes = memory->total_processes;
+    saved_memory.max_order = memory->max_order;
+    saved_memory.largest_free_min = memory->largest_free_min;
+    saved_memory.pages_loaded = memory->pages_loaded;
+    saved_memory.frag_samples = memory->frag_samples;
+    saved_memory.largest_free_total = memory->largest_free_total;
+    saved_memory.frag_total = memory->frag_total;
+    saved_memory.frag_max = memory->frag_max;
+    put(output, &offset, &saved_memory, sizeof(saved_memory));
+    put(output, &offset, memory->pages, memory->map_words*sizeof(uint64_t));
+    if (header.flags & SNAPSHOT_HAS_REFERENCES) {
+        put(output, &offset, memory->referenced, memory->map_words*sizeof(uint64_t));
+    }
+    if (header.flags & SNAPSHOT_HAS_BUDDY) {
+        put(output, &offset, memory->free_heads, (memory->max_order + 1)*sizeof(int32_t));
+        put(output, &offset, memory->next_block, memory->total_pages*sizeof(int32_t));
+        put(output, &offset, memory->prev_block, memory->total_pages*sizeof(int32_t));
+        put(output, &offset, memory->block_order, memory->total_pages);
+    }
+
+    header.stats_offset = align(output, &offset);
+    memset(&saved_stats, 0, sizeof(saved_stats));
+    memcpy(saved_stats.throughput, stats->throughput, sizeof(saved_stats.throughput));
+    saved_stats.turnaround = stats->turnaround;
+    saved_stats.overhead[OVR_MAX] = stats->overhead[OVR_MAX];
+    saved_stats.overhead[OVR_AVG] = stats->overhead[OVR_AVG];
+    saved_stats.finished_processes = stats->finished_processes;
+    saved_stats.num_levels = stats->num_levels;
+    saved_stats.core_busy = stats->core_busy[0];
+    put(output, &offset, &saved_stats, sizeof(saved_stats));
+    for (i=0; i<stats->num_levels; i++) {
+        total = stats->level_turnaround[i];
+        put(output, &offset, &total, sizeof(total));
+    }
+    put(output, &offset, stats->level_finished, stats->num_levels*sizeof(int32_t));
+    align(output, &offset);
+    if (header.flags & SNAPSHOT_HAS_HISTOGRAMS) {
+        for (i=0; i<NUM_HISTS; i++) {
+            put(output, &offset, stats->histograms[i], sizeof(Histogram));
+        }
+    }
+
+    fseek(output, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, output);
+    if (fclose(output) != 0) {
+        fprintf(stderr, "Could not write %s: %s\n", checkpoint->save_file, strerror(errno));
+        exit(1);
+    }
+    checkpoint->saved = 1;
+}
+
+// Exits with a message when a snapshot doesn't fit the simulation restoring it
+static void mismatch(Checkpoint *checkpoint, int fits, const char *what) {
+    if (!fits) {
+        fprintf(stderr, "Snapshot %s doesn't match this run: %s\n", checkpoint->restore_file,
+                what);
+        exit(1);
+    }
+}
+
+// Returns the section at offset, exiting if size bytes from it run past the mapping
+static const char *section(Checkpoint *checkpoint, const char *mapping, size_t mapping_size,
+                           uint64_t offset, uint64_t size) {
+    mismatch(checkpoint, (offset <= mapping_size) && (size <= mapping_size - offset),
+             "it is cut short");
+    return mapping + offset;
+}
+
+/* Restores the snapshot in the checkpoint's restore file into a simulation
+   just set up with the same trace and memory options, refilling its empty
+   queues and memory, and returns the clock to carry on from. next_boost may
+   be NULL. Exits if the snapshot doesn't fit the simulation */
+int restore_checkpoint(Checkpoint *checkpoint, Trace *trace, Deque **queues, int num_queues,
+                       Heap *heap, long *next_boost, Memory *memory, Statistics *stats) {
+    int fd, i, q, page, first;
+    size_t mapping_size;
+    struct stat file_stat;
+    const char *mapping, *cursor;
+    const SnapshotHeader *header;
+    const SnapshotProcess *records;
+    const SnapshotMemory *saved_memory;
+    const SnapshotStats *saved_stats;
+    const int32_t *pages, *queue_sizes, *heap_sizes, *resident;
+    const int64_t *level_totals;
+    uint32_t flags;
+    Process **restored, *process;
+
+    fd = open(checkpoint->restore_file, O_RDONLY);
+    if ((fd < 0) || (fstat(fd, &file_stat) < 0)) {
+        fprintf(stderr, "Could not open %s: %s\n", checkpoint->restore_file, strerror(errno));
+        exit(1);
+    }
+    mapping_size = file_stat.st_size;
+    mismatch(checkpoint, mapping_size >= sizeof(SnapshotHeader), "it is too short");
+    mapping = (const char*)mmap(NULL, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Could not map %s: %s\n", checkpoint->restore_file, strerror(errno));
+        exit(1);
+    }
+    header = (const SnapshotHeader*)mapping;
+    mismatch(checkpoint, (!memcmp(header->magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN)) &&
+             (header->version == SNAPSHOT_VERSION), "it isn't a snapshot of this version");
+    mismatch(checkpoint, !strncmp(header->mem_alloc, checkpoint->mem_alloc, SNAPSHOT_NAME),
+             "the memory allocation differs");
+    mismatch(checkpoint, (header->trace_count == trace->count) &&
+             (header->trace_next <= trace->count), "the trace differs");
+    mismatch(checkpoint, header->num_queues == num_queues, "the number of queues differs");
+    flags = header->flags;
+    mismatch(checkpoint, ((flags & SNAPSHOT_HAS_REFERENCES) != 0) == (memory->referenced != NULL),
+             "reference bits are only kept by clock");
+    mismatch(checkpoint, ((flags & SNAPSHOT_HAS_BUDDY) != 0) == (memory->block_order != NULL),
+             "--buddy differs");
+    mismatch(checkpoint, ((flags & SNAPSHOT_HAS_HISTOGRAMS) != 0) ==
+             (stats->histograms[HIST_TURNAROUND] != NULL), "--percentiles differs");
+
+    records = (const SnapshotProcess*)section(checkpoint, mapping, mapping_size,
+                                              header->processes_offset,
+                                              (uint64_t)header->num_processes*sizeof(*records));
+    pages = (const int32_t*)section(checkpoint, mapping, mapping_size, header->pages_offset,
+                                    (uint64_t)header->num_pages*sizeof(int32_t));
+    queue_sizes = (const int32_t*)section(checkpoint, mapping, mapping_size,
+                                          header->queues_offset,
+                                          2*(uint64_t)num_queues*sizeof(int32_t));
+    heap_sizes = queue_sizes + num_queues;
+    resident = (const int32_t*)section(checkpoint, mapping, mapping_size,
+                                       header->resident_offset,
+                                       (uint64_t)header->num_resident*sizeof(int32_t));
+
+    // Memory, everything but the page lists and resident list
+    saved_memory = (const SnapshotMemory*)section(checkpoint, mapping, mapping_size,
+                                                  header->memory_offset,
+                                                  sizeof(SnapshotMemory));
+    mismatch(checkpoint, (saved_memory->total_pages == memory->total_pages) &&
+             (saved_memory->max_order == memory->max_order), "the memory size differs");
+    cursor = section(checkpoint, mapping, mapping_size,
+                     header->memory_offset + sizeof(SnapshotMemory),
+                     memory->map_words*sizeof(uint64_t));
+    memcpy(memory->pages, cursor, memory->map_words*sizeof(uint64_t));
+    cursor += memory->map_words*sizeof(uint64_t);
+    if (flags & SNAPSHOT_HAS_REFERENCES) {
+        cursor = section(checkpoint, mapping, mapping_size, cursor - mapping,
+                         memory->map_words*sizeof(uint64_t));
+        memcpy(memory->referenced, cursor, memory->map_words*sizeof(uint64_t));
+        cursor += memory->map_words*sizeof(uint64_t);
+    }
+    if (flags & SNAPSHOT_HAS_BUDDY) {
+        cursor = section(checkpoint, mapping, mapping_size, cursor - mapping,
+                         (memory->max_order + 1 + 2*(uint64_t)memory->total_pages)
+                         *sizeof(int32_t) + memory->total_pages);
+        memcpy(memory->free_heads, cursor, (memory->max_order + 1)*sizeof(int32_t));
+        cursor += (memory->max_order + 1)*sizeof(int32_t);
+        memcpy(memory->next_block, cursor, memory->total_pages*sizeof(int32_t));
+        cursor += memory->total_pages*sizeof(int32_t);
+        memcpy(memory->prev_block, cursor, memory->total_pages*sizeof(int32_t));
+        cursor += memory->total_pages*sizeof(int32_t);
+        memcpy(memory->block_order, cursor, memory->total_pages);
+    }
+    memory->empty_pages = saved_memory->empty_pages;
+    memory->first_free = saved_memory->first_free;
+    memory->hand = saved_memory->hand;
+    memory->mem_usage = saved_memory->mem_usage;
+    memory->total_processes = saved_memory->total_processes;
+    memory->largest_free_min = saved_memory->largest_free_min;
+    memory->pages_loaded = saved_memory->pages_loaded;
+    memory->frag_samples = saved_memory->frag_samples;
+    memory->largest_free_total = saved_memory->largest_free_total;
+    memory->frag_total = saved_memory->frag_total;
+    memory->frag_max = saved_memory->frag_max;
+
+    // Processes go back into their queues with the pages they held
+    restored = (Process**)malloc((header->num_processes + 1)*sizeof(Process*));
+    first = 0;
+    for (i=0; i<header->num_processes; i++) {
+        process = new_process(trace);
+        process->arrival_time = records[i].arrival_time;
+        process->pid = records[i].pid;
+        process->mem_req = records[i].mem_req;
+        process->job_time = records[i].job_time;
+        process->remaining_time = records[i].remaining_time;
+        process->arrival_order = records[i].arrival_order;
+        process->next_reference = records[i].next_reference;
+        process->mem_start = 0;
+        process->pages_used = records[i].pages_used;
+        mismatch(checkpoint, (first + process->pages_used <= header->num_pages) &&
+                 (process->pages_used <= process->mem_req), "its page lists are corrupt");
+        if ((process->pages_used > 0) && (process->mem_capacity < process->mem_req)) {
+            // Same power of two capacity allocate_memory() gives
+            process->mem_capacity = 1;
+            while (process->mem_capacity < process->mem_req) {
+                process->mem_capacity *= 2;
+            }
+            process->mem_index = (int*)arena_alloc(memory->page_lists,
+                                                   process->mem_capacity*sizeof(int));
+        }
+        memcpy(process->mem_index, pages + first, process->pages_used*sizeof(int));
+        for (page=0; page<process->pages_used; page++) {
+            mismatch(checkpoint, (unsigned)process->mem_index[page] <
+                     (unsigned)memory->total_pages, "its page lists are corrupt");
+            if (memory->owners != NULL) {
+                memory->owners[process->mem_index[page]] = process;
+            }
+        }
+        first += process->pages_used;
+        restored[i] = process;
+    }
+    first = 0;
+    for (q=0; q<num_queues; q++) {
+        mismatch(checkpoint, (queue_sizes[q] >= 0) &&
+                 (first + queue_sizes[q] <= header->num_processes), "its queues are corrupt");
+        for (i=0; i<queue_sizes[q]; i++) {
+            deque_append(queues[q], restored[first + i]);
+        }
+        first += queue_sizes[q];
+    }
+    // A heap in another order is rebuilt from scratch by the next heap_fill()
+    if ((heap != NULL) && (heap->key == header->heap_key) && (heap_sizes[0] <= queue_sizes[0])) {
+        heap->size = heap_sizes[0];
+    }
+    for (i=0; i<header->num_resident; i++) {
+        mismatch(checkpoint, (resident[i] >= 0) && (resident[i] < header->num_processes),
+                 "its resident list is corrupt");
+        append_resident(memory, restored[resident[i]]);
+    }
+    free(restored);
+
+    saved_stats = (const SnapshotStats*)section(checkpoint, mapping, mapping_size,
+                                                header->stats_offset, sizeof(SnapshotStats));
+    mismatch(checkpoint, saved_stats->num_levels == stats->num_levels,
+             "the number of levels differs");
+    memcpy(stats->throughput, saved_stats->throughput, sizeof(saved_stats->throughput));
+    stats->turnaround = saved_stats->turnaround;
+    stats->overhead[OVR_MAX] = saved_stats->overhead[OVR_MAX];
+    stats->overhead[OVR_AVG] = saved_stats->overhead[OVR_AVG];
+    stats->finished_processes = saved_stats->finished_processes;
+    stats->core_busy[0] = saved_stats->core_busy;
+    cursor = section(checkpoint, mapping, mapping_size,
+                     header->stats_offset + sizeof(SnapshotStats),
+                     stats->num_levels*(sizeof(int64_t) + sizeof(int32_t)));
+    level_totals = (const int64_t*)cursor;
+    for (i=0; i<stats->num_levels; i++) {
+        stats->level_turnaround[i] = level_totals[i];
+    }
+    cursor += stats->num_levels*sizeof(int64_t);
+    memcpy(stats->level_finished, cursor, stats->num_levels*sizeof(int32_t));
+    cursor += stats->num_levels*sizeof(int32_t);
+    if (flags & SNAPSHOT_HAS_HISTOGRAMS) {
+        // Histograms start on the next section boundary
+        first = (cursor - mapping) % SNAPSHOT_ALIGN;
+        cursor = section(checkpoint, mapping, mapping_size,
+                         cursor - mapping + (first ? SNAPSHOT_ALIGN - first : 0),
+                         NUM_HISTS*sizeof(Histogram));
+        for (i=0; i<NUM_HISTS; i++) {
+            memcpy(stats->histograms[i], cursor + i*sizeof(Histogram), sizeof(Histogram));
+        }
+    }
+
+    trace->next = header->trace_next;
+    if (next_boost != NULL) {
+        *next_boost = header->next_boost;
+    }
+    i = header->clock;
+    munmap((void*)mapping, mapping_size);
+    return i;
+}
@@ -0,0 +1,140 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+#define SNAPSHOT_MAGIC "SCHSNAPS"
+#define SNAPSHOT_MAGIC_LEN 8
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_NAME 8
+#define SNAPSHOT_ALIGN 8
+#define SNAPSHOT_HAS_REFERENCES 1
+#define SNAPSHOT_HAS_BUDDY 2
+#define SNAPSHOT_HAS_HISTOGRAMS 4
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "trace.h"
+#include "process-heap.h"
+#include "memory.h"
+#include "statistics.h"
+
+/* Checkpoint and restore of a single core simulation. A snapshot is taken at
+   the top of a scheduling loop, where every process that has arrived but not
+   finished sits in one of the policy's queues, so the queues, the trace
+   position, the memory and the statistics are the whole state.
+
+   Snapshot layout: this header, then sections starting at the offsets it
+   gives, each aligned to SNAPSHOT_ALIGN bytes and made of fixed size
+   records, so a mapping of the file can be read in place:
+     processes  num_processes SnapshotProcess records
+     pages      the held pages of every process in turn, int32 each
+     queues     num_queues queue sizes then num_queues heap sizes, int32
+                each, the processes above fill the queues in order
+     resident   num_resident process indexes, least recently executed first
+     memory     a SnapshotMemory, the empty page bitmap, then the reference
+                bitmap and buddy free lists if flags says they are there
+     stats      a SnapshotStats, the int64 turnaround and int32 finished
+                count of every mlfq level, then, aligned, the histograms
+                if flags says they are there */
+
+typedef struct snapshot_header SnapshotHeader;
+typedef struct snapshot_process SnapshotProcess;
+typedef struct snapshot_memory SnapshotMemory;
+typedef struct snapshot_stats SnapshotStats;
+typedef struct checkpoint Checkpoint;
+
+struct snapshot_header {
+    char magic[SNAPSHOT_MAGIC_LEN];
+    uint32_t version;
+    uint32_t header_size;
+    char sched_alg[SNAPSHOT_NAME]; // Only informative, restored runs may use another policy
+    char mem_alloc[SNAPSHOT_NAME];
+    int64_t clock;
+    int64_t trace_count;
+    int64_t trace_next; // Index of the next process to arrive
+    int64_t next_boost; // mlfq only
+    uint32_t flags;
+    int32_t num_processes;
+    int32_t num_pages;
+    int32_t num_queues;
+    int32_t num_resident;
+    int32_t heap_key; // Order of the heap over the first queue, -1 without one
+    uint64_t processes_offset;
+    uint64_t pages_offset;
+    uint64_t queues_offset;
+    uint64_t resident_offset;
+    uint64_t memory_offset;
+    uint64_t stats_offset;
+};
+
+struct snapshot_process {
+    int32_t arrival_time;
+    int32_t pid;
+    int32_t mem_req; // In pages
+    int32_t job_time;
+    int32_t remaining_time;
+    int32_t pages_used;
+    int32_t arrival_order;
+    int32_t next_reference;
+};
+
+struct snapshot_memory {
+    int32_t total_pages;
+    int32_t empty_pages;
+    int32_t first_free;
+    int32_t hand;
+    int32_t mem_usage;
+    int32_t total_processes;
+    int32_t max_order;
+    int32_t largest_free_min;
+    int64_t pages_loaded;
+    int64_t frag_samples;
+    int64_t largest_free_total;
+    double frag_total;
+    double frag_max;
+};
+
+struct snapshot_stats {
+    int32_t throughput[5];
+    int32_t turnaround;
+    float overhead[2];
+    int32_t finished_processes;
+    int32_t num_levels;
+    int64_t core_busy; // Single core runs only
+};
+
+struct checkpoint {
+    char *save_file; // NULL unless a snapshot is to be taken
+    int save_at; // The first loop starting at or after this time is saved
+    int saved;
+    char *restore_file; // NULL unless the run starts from a snapshot
+    char *sched_alg;
+    char *mem_alloc;
+};
+
+// Checks whether a simulation starts from a snapshot, checkpoint may be NULL
+int checkpoint_restoring(Checkpoint *checkpoint);
+
+// Checks whether a simulation at clock should be saved now, checkpoint may be NULL
+int checkpoint_due(Checkpoint *checkpoint, int clock);
+
+/* Writes a snapshot of a simulation at clock to the checkpoint's save file.
+   queues hold every arrived process that hasn't finished, heap orders the
+   first of them and may be NULL, and next_boost is only used by mlfq */
+void save_checkpoint(Checkpoint *checkpoint, int clock, Trace *trace, Deque **queues,
+                     int num_queues, Heap *heap, long next_boost, Memory *memory,
+                     Statistics *stats);
+
+/* Restores the snapshot in the checkpoint's restore file into a simulation
+   just set up with the same trace and memory options, refilling its empty
+   queues and memory, and returns the clock to carry on from. next_boost may
+   be NULL. Exits if the snapshot doesn't fit the simulation */
+int restore_checkpoint(Checkpoint *checkpoint, Trace *trace, Deque **queues, int num_queues,
+                       Heap *heap, long *next_boost, Memory *memory, Statistics *stats);
+
+#endif
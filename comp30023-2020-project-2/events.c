@@ -0,0 +1,335 @@
+/* Event log, rendered in place or on a pipeline of threads */
+#include "events.h"
+#include "memory.h"
+
+#define WINDOW_FREE 0
+#define WINDOW_FILLING 1
+#define WINDOW_READY 2
+#define WINDOW_FORMATTING 3
+#define WINDOW_FORMATTED 4
+#define WINDOW_TEXT (1 << 18)
+
+
+static Window *windows = NULL;
+static int num_windows;
+static Window *filling = NULL; // Window the simulation appends to, NULL when serial
+static long next_fill; // Sequence numbers of the windows each stage handles next
+static long next_format;
+static long next_write;
+static int closing;
+static int num_formatters;
+static pthread_t *formatters;
+static pthread_t writer;
+static pthread_t owner; // Thread running the simulation
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t changed = PTHREAD_COND_INITIALIZER;
+
+// Formats a RUNNING line
+static void format_running(Output *out, int clock, int pid, int remaining_time,
+                           int load_time, int mem_usage, int core, int *pages,
+                           int num_pages) {
+    int i=0;
+
+    buffer_int(out, clock);
+    buffer_str(out, ", RUNNING, id=");
+    buffer_int(out, pid);
+    if (core != NO_CORE) {
+        buffer_str(out, ", core=");
+        buffer_int(out, core);
+    }
+    buffer_str(out, ", remaining-time=");
+    buffer_int(out, remaining_time);
+    // Negative usage means memory is unlimited
+    if (mem_usage >= 0) {
+        buffer_str(out, ", load-time=");
+        buffer_int(out, load_time);
+        buffer_str(out, ", mem-usage=");
+        buffer_int(out, mem_usage);
+        buffer_str(out, "%, mem-addresses=[");
+        while (i < num_pages) {
+            buffer_int(out, pages[i]);
+            if (i == num_pages - 1) {
+                buffer_str(out, "]\n");
+            } else {
+                buffer_char(out, ',');
+            }
+            i++;
+        }
+    } else {
+        buffer_char(out, '\n');
+    }
+}
+
+// Formats a FINISHED line
+static void format_finished(Output *out, int clock, int pid, int proc_remaining, int core) {
+    buffer_int(out, clock);
+    buffer_str(out, ", FINISHED, id=");
+    buffer_int(out, pid);
+    if (core != NO_CORE) {
+        buffer_str(out, ", core=");
+        buffer_int(out, core);
+    }
+    buffer_str(out, ", proc-remaining=");
+    buffer_int(out, proc_remaining);
+    buffer_char(out, '\n');
+}
+
+// Formats an EVICTED line, sorting the pages first
+static void format_evicted(Output *out, int clock, int *pages, int num_pages) {
+    int i=0;
+
+    qsort(pages, num_pages, sizeof(int), page_comp);
+    buffer_int(out, clock);
+    buffer_str(out, ", EVICTED, mem-addresses=[");
+    while (i < num_pages) {
+        buffer_int(out, pages[i]);
+        if (i == num_pages - 1) {
+            buffer_str(out, "]\n");
+        } else {
+            buffer_char(out, ',');
+        }
+        i++;
+    }
+}
+
+// Turns the records of a window into text
+static void render(Window *window) {
+    int32_t *record = window->records;
+    int32_t *end = window->records + window->used;
+
+    while (record < end) {
+        if (record[0] == EVENT_RUNNING) {
+            format_running(&window->text, record[1], record[2], record[3], record[4],
+                           record[5], record[6], (int*)(record + 8), record[7]);
+            record += 8 + record[7];
+        } else if (record[0] == EVENT_FINISHED) {
+            format_finished(&window->text, record[1], record[2], record[3], record[4]);
+            record += 5;
+        } else {
+            format_evicted(&window->text, record[1], (int*)(record + 3), record[2]);
+            record += 3 + record[2];
+        }
+    }
+}
+
+// Formatting thread, renders published windows in the order they were filled
+static void *format_windows(void *arg) {
+    Window *window;
+
+    pthread_mutex_lock(&lock);
+    while (1) {
+        while ((next_format == next_fill) && (!closing)) {
+            pthread_cond_wait(&changed, &lock);
+        }
+        if (next_format == next_fill) {
+            break;
+        }
+        window = &windows[next_format % num_windows];
+        window->state = WINDOW_FORMATTING;
+        next_format++;
+        pthread_mutex_unlock(&lock);
+        render(window);
+        pthread_mutex_lock(&lock);
+        window->state = WINDOW_FORMATTED;
+        pthread_cond_broadcast(&changed);
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+// Writer thread, writes rendered windows out in order and frees them for reuse
+static void *write_windows(void *arg) {
+    Window *window;
+
+    pthread_mutex_lock(&lock);
+    while (1) {
+        while (((next_write == next_fill) && (!closing)) ||
+               ((next_write < next_fill) &&
+                (windows[next_write % num_windows].state != WINDOW_FORMATTED))) {
+            pthread_cond_wait(&changed, &lock);
+        }
+        if (next_write == next_fill) {
+            break;
+        }
+        window = &windows[next_write % num_windows];
+        pthread_mutex_unlock(&lock);
+        write_all(STDOUT_FILENO, window->text.buffer, window->text.used);
+        window->text.used = 0;
+        window->used = 0;
+        pthread_mutex_lock(&lock);
+        window->state = WINDOW_FREE;
+        next_write++;
+        pthread_cond_broadcast(&changed);
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+// Hands the filling window to the formatters and waits for the next one to be free
+static void publish() {
+    pthread_mutex_lock(&lock);
+    filling->state = WINDOW_READY;
+    next_fill++;
+    pthread_cond_broadcast(&changed);
+    filling = &windows[next_fill % num_windows];
+    while (filling->state != WINDOW_FREE) {
+        pthread_cond_wait(&changed, &lock);
+    }
+    filling->state = WINDOW_FILLING;
+    pthread_mutex_unlock(&lock);
+}
+
+// Returns space for a record of count values in the filling window
+static int32_t *reserve(int count) {
+    int32_t *record;
+
+    if (filling->used + count > filling->capacity) {
+        if (filling->used > 0) {
+            publish();
+        }
+        // Records never span windows, so a huge one gets a window to itself
+        if (count > filling->capacity) {
+            filling->capacity = count;
+            filling->records = (int32_t*)realloc(filling->records, count*sizeof(int32_t));
+        }
+    }
+    record = filling->records + filling->used;
+    filling->used += count;
+    return record;
+}
+
+// Starts rendering the event log on the given number of formatting threads
+void start_events(int threads) {
+    int i;
+    static int registered = 0;
+
+    // Anything already buffered comes before the log
+    flush_output();
+    num_formatters = threads;
+    num_windows = WINDOWS_PER_THREAD*threads + 2;
+    windows = (Window*)malloc(num_windows*sizeof(Window));
+    for (i=0; i<num_windows; i++) {
+        windows[i].capacity = WINDOW_RECORDS;
+        windows[i].records = (int32_t*)malloc(WINDOW_RECORDS*sizeof(int32_t));
+        windows[i].used = 0;
+        windows[i].text.buffer = (char*)malloc(WINDOW_TEXT);
+        windows[i].text.capacity = WINDOW_TEXT;
+        windows[i].text.used = 0;
+        windows[i].text.fd = -1;
+        windows[i].state = WINDOW_FREE;
+    }
+    next_fill = next_format = next_write = 0;
+    closing = 0;
+    filling = &windows[0];
+    filling->state = WINDOW_FILLING;
+    owner = pthread_self();
+
+    formatters = (pthread_t*)malloc(threads*sizeof(pthread_t));
+    for (i=0; i<threads; i++) {
+        if (pthread_create(&formatters[i], NULL, format_windows, NULL)) {
+            fprintf(stderr, "Failed to start event thread\n");
+            exit(1);
+        }
+    }
+    if (pthread_create(&writer, NULL, write_windows, NULL)) {
+        fprintf(stderr, "Failed to start event thread\n");
+        exit(1);
+    }
+    // Runs that end through exit() still get their log out
+    if (!registered) {
+        atexit(finish_events);
+        registered = 1;
+    }
+}
+
+// Writes out every event logged so far and stops the threads, if running
+void finish_events() {
+    int i;
+
+    // Only the simulation can stop the pipeline, a failing thread just exits
+    if ((filling == NULL) || (!pthread_equal(owner, pthread_self()))) {
+        return;
+    }
+    pthread_mutex_lock(&lock);
+    if (filling->used > 0) {
+        filling->state = WINDOW_READY;
+        next_fill++;
+    }
+    closing = 1;
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&lock);
+
+    for (i=0; i<num_formatters; i++) {
+        pthread_join(formatters[i], NULL);
+    }
+    pthread_join(writer, NULL);
+    for (i=0; i<num_windows; i++) {
+        free(windows[i].records);
+        free(windows[i].text.buffer);
+    }
+    free(windows);
+    free(formatters);
+    windows = NULL;
+    filling = NULL;
+}
+
+// Logs a process starting to run, the core is left out when it is NO_CORE
+void log_running(int clock, int pid, int remaining_time, int load_time,
+                 int mem_usage, int core, int *pages, int num_pages) {
+    int32_t *record;
+
+    if (filling == NULL) {
+        format_running(&standard_output, clock, pid, remaining_time, load_time,
+                       mem_usage, core, pages, num_pages);
+        return;
+    }
+    // Pages are only listed with limited memory
+    if (mem_usage < 0) {
+        num_pages = 0;
+    }
+    record = reserve(8 + num_pages);
+    record[0] = EVENT_RUNNING;
+    record[1] = clock;
+    record[2] = pid;
+    record[3] = remaining_time;
+    record[4] = load_time;
+    record[5] = mem_usage;
+    record[6] = core;
+    record[7] = num_pages;
+    if (num_pages > 0) {
+        memcpy(record + 8, pages, num_pages*sizeof(int32_t));
+    }
+}
+
+// Logs a process finishing, the core is left out when it is NO_CORE
+void log_finished(int clock, int pid, int proc_remaining, int core) {
+    int32_t *record;
+
+    if (filling == NULL) {
+        format_finished(&standard_output, clock, pid, proc_remaining, core);
+        return;
+    }
+    record = reserve(5);
+    record[0] = EVENT_FINISHED;
+    record[1] = clock;
+    record[2] = pid;
+    record[3] = proc_remaining;
+    record[4] = core;
+}
+
+// Logs evicted pages, which may be reordered
+void log_evicted(int clock, int *pages, int num_pages) {
+    int32_t *record;
+
+    if (filling == NULL) {
+        format_evicted(&standard_output, clock, pages, num_pages);
+        return;
+    }
+    record = reserve(3 + num_pages);
+    record[0] = EVENT_EVICTED;
+    record[1] = clock;
+    record[2] = num_pages;
+    if (num_pages > 0) {
+        memcpy(record + 3, pages, num_pages*sizeof(int32_t));
+    }
+}
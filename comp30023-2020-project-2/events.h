@@ -0,0 +1,49 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+#define WINDOW_RECORDS (1 << 16)
+#define WINDOWS_PER_THREAD 2
+#define EVENT_RUNNING 0
+#define EVENT_FINISHED 1
+#define EVENT_EVICTED 2
+#define NO_CORE -1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "output.h"
+
+/* Event log. Events are formatted straight into the stdout buffer, unless
+   the log is rendered on threads: then the simulation only appends compact
+   records to a window, full windows are turned into text by a pool of
+   formatting threads, and a writer thread writes the text out in window
+   order, so the log is identical to the serial one. */
+
+typedef struct window Window;
+
+struct window {
+    int32_t *records;
+    int used;
+    int capacity;
+    Output text;
+    int state;
+};
+
+// Starts rendering the event log on the given number of formatting threads
+void start_events(int threads);
+
+// Writes out every event logged so far and stops the threads, if running
+void finish_events();
+
+// Logs a process starting to run, the core is left out when it is NO_CORE
+void log_running(int clock, int pid, int remaining_time, int load_time,
+                 int mem_usage, int core, int *pages, int num_pages);
+
+// Logs a process finishing, the core is left out when it is NO_CORE
+void log_finished(int clock, int pid, int proc_remaining, int core);
+
+// Logs evicted pages, which may be reordered
+void log_evicted(int clock, int *pages, int num_pages);
+
+#endif
@@ -0,0 +1,75 @@
+/* Fixed size log-linear histogram for percentiles of unbounded streams */
+#include "histogram.h"
+
+
+// Returns the bucket a value falls in
+static int bucket_of(uint64_t value) {
+    int shift;
+
+    if (value < HIST_SUB) {
+        return (int)value;
+    }
+    // Keep the top HIST_SUB_BITS + 1 bits, the leading one picks the group
+    shift = 63 - __builtin_clzll(value) - HIST_SUB_BITS;
+    return (shift + 1) * HIST_SUB + (int)((value >> shift) - HIST_SUB);
+}
+
+// Returns the highest value falling in a bucket
+static long bucket_top(int bucket) {
+    int shift = bucket / HIST_SUB - 1;
+
+    if (shift < 0) {
+        return bucket;
+    }
+    return (long)((((uint64_t)(bucket % HIST_SUB + HIST_SUB) + 1) << shift) - 1);
+}
+
+// Create a new empty Histogram and return a pointer to it
+Histogram *new_histogram() {
+    return (Histogram*)calloc(1, sizeof(Histogram));
+}
+
+// Counts one value, negative values count as 0
+void histogram_record(Histogram *histogram, long value) {
+    if (value < 0) {
+        value = 0;
+    }
+    histogram->counts[bucket_of(value)] += 1;
+    histogram->total += 1;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+/* Returns the value at or below which percentile percent of the recorded
+   values fall, as the highest value sharing its bucket, or 0 if none are */
+long histogram_percentile(Histogram *histogram, double percentile) {
+    int bucket;
+    long seen = 0, rank;
+    double target;
+
+    if (histogram->total == 0) {
+        return 0;
+    }
+    // The smallest rank covering the percentile, at least the first value
+    target = percentile / 100 * histogram->total - HIST_EPSILON;
+    rank = (long)target;
+    if (rank < target) {
+        rank++;
+    }
+    if (rank < 1) {
+        rank = 1;
+    }
+    for (bucket=0; bucket<HIST_BUCKETS; bucket++) {
+        seen += histogram->counts[bucket];
+        if (seen >= rank) {
+            break;
+        }
+    }
+    // No recorded value is above the maximum, even if its bucket reaches further
+    return (bucket_top(bucket) < histogram->max) ? bucket_top(bucket) : histogram->max;
+}
+
+void free_histogram(Histogram *histogram) {
+    free(histogram);
+}
@@ -0,0 +1,37 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+#define HIST_SUB_BITS 7
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB)
+#define HIST_EPSILON 1e-9 // Keeps rounding in percentile * total from adding a rank
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+typedef struct histogram Histogram;
+
+/* Log-linear histogram of non-negative values, in the style of HDR
+   histograms. Values below HIST_SUB each get their own bucket, larger ones
+   share a bucket with the values agreeing in their top HIST_SUB_BITS + 1
+   bits, so a bucket is never wider than 1/HIST_SUB of its values. Recording
+   is O(1) and the memory used never grows with the number of values. */
+struct histogram {
+    long counts[HIST_BUCKETS];
+    long total;
+    long max;
+};
+
+// Create a new empty Histogram and return a pointer to it
+Histogram *new_histogram();
+
+// Counts one value, negative values count as 0
+void histogram_record(Histogram *histogram, long value);
+
+/* Returns the value at or below which percentile percent of the recorded
+   values fall, as the highest value sharing its bucket, or 0 if none are */
+long histogram_percentile(Histogram *histogram, double percentile);
+
+void free_histogram(Histogram *histogram);
+
+#endif
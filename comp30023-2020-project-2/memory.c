@@ -3,86 +3,552 @@
 
 Memory *init_memory(int mem_size) {
     Memory *new_memory;
+    int spare_bits;
 
     new_memory = (Memory*)malloc(sizeof(Memory));
     new_memory->total_pages = mem_size/KB_PER_PAGE;
     new_memory->empty_pages = new_memory->total_pages;
     new_memory->total_processes = 0;
     new_memory->mem_usage = 0;
-    new_memory->pages = (int*)malloc((new_memory->total_pages)*sizeof(int));
-    if (new_memory->total_pages) {
-        memset(new_memory->pages, 0, new_memory->total_pages*sizeof(int));
+    new_memory->map_words = (new_memory->total_pages + PAGES_PER_WORD - 1) / PAGES_PER_WORD;
+    new_memory->first_free = 0;
+    new_memory->pages = (uint64_t*)malloc((new_memory->map_words)*sizeof(uint64_t));
+    new_memory->scratch = (int*)malloc((new_memory->total_pages)*sizeof(int));
+    new_memory->page_lists = new_arena();
+    new_memory->least_recent = NULL;
+    new_memory->most_recent = NULL;
+    new_memory->resident_pages = 0;
+    new_memory->referenced = NULL;
+    new_memory->owners = NULL;
+    new_memory->hand = 0;
+    new_memory->pages_loaded = 0;
+    new_memory->max_order = 0;
+    new_memory->free_heads = NULL;
+    new_memory->next_block = NULL;
+    new_memory->prev_block = NULL;
+    new_memory->block_order = NULL;
+    new_memory->frag_samples = 0;
+    new_memory->largest_free_total = 0;
+    new_memory->largest_free_min = new_memory->total_pages;
+    new_memory->frag_total = 0.0;
+    new_memory->frag_max = 0.0;
+    if (new_memory->map_words) {
+        memset(new_memory->pages, 0xff, new_memory->map_words*sizeof(uint64_t));
+        // Bits past the last page must never look empty
+        spare_bits = new_memory->map_words*PAGES_PER_WORD - new_memory->total_pages;
+        new_memory->pages[new_memory->map_words-1] >>= spare_bits;
     }
 
     return new_memory;
 }
 
+// Merges ascending new_pages into the sorted pages already held by process
+static void merge_pages(Process *process, int *new_pages, int count) {
+    int *held = process->mem_index;
+    int i, j, write;
+
+    // Slide held pages to the front so the merged run fits in mem_index
+    if (process->mem_start > 0) {
+        memmove(held, held + process->mem_start, process->pages_used*sizeof(int));
+        process->mem_start = 0;
+    }
+
+    // Merge from the back, stops as soon as every new page has been placed
+    i = process->pages_used - 1;
+    j = count - 1;
+    write = process->pages_used + count - 1;
+    while (j >= 0) {
+        if ((i >= 0) && (held[i] > new_pages[j])) {
+            held[write--] = held[i--];
+        } else {
+            held[write--] = new_pages[j--];
+        }
+    }
+    process->pages_used += count;
+}
+
+// Checks whether a process is in the resident list
+static int is_resident(Memory *memory, Process *process) {
+    return (process->prev_resident != NULL) || (memory->least_recent == process);
+}
+
+// Removes a free block from the list of its order
+static void unlink_block(Memory *memory, int start, int order) {
+    if (memory->prev_block[start] < 0) {
+        memory->free_heads[order] = memory->next_block[start];
+    } else {
+        memory->next_block[memory->prev_block[start]] = memory->next_block[start];
+    }
+    if (memory->next_block[start] >= 0) {
+        memory->prev_block[memory->next_block[start]] = memory->prev_block[start];
+    }
+    memory->block_order[start] = -1;
+}
+
+// Adds a free block to the front of the list of its order
+static void link_block(Memory *memory, int start, int order) {
+    memory->prev_block[start] = -1;
+    memory->next_block[start] = memory->free_heads[order];
+    if (memory->free_heads[order] >= 0) {
+        memory->prev_block[memory->free_heads[order]] = start;
+    }
+    memory->free_heads[order] = start;
+    memory->block_order[start] = order;
+}
+
+// Frees a single page, merging it with its buddy for as long as the buddy is free too
+static void buddy_free(Memory *memory, int page) {
+    int order = 0;
+    int buddy;
+
+    while (order < memory->max_order) {
+        buddy = page ^ (1 << order);
+        if ((buddy >= memory->total_pages) || (memory->block_order[buddy] != order)) {
+            break;
+        }
+        unlink_block(memory, buddy, order);
+        page &= ~(1 << order);
+        order++;
+    }
+    link_block(memory, page, order);
+}
+
+// Takes a free block of the given order, splitting a larger one if needed. Returns -1 if none is
+static int buddy_take(Memory *memory, int order) {
+    int start, larger = order;
+
+    while ((larger <= memory->max_order) && (memory->free_heads[larger] < 0)) {
+        larger++;
+    }
+    if (larger > memory->max_order) {
+        return -1;
+    }
+    start = memory->free_heads[larger];
+    unlink_block(memory, start, larger);
+    // The upper halves go back on the free lists
+    while (larger > order) {
+        larger--;
+        link_block(memory, start + (1 << larger), larger);
+    }
+    return start;
+}
+
+// Ascending comparator for page numbers
+static int int_comp(const void *first, const void *second) {
+    return *(const int*)first - *(const int*)second;
+}
+
+// Takes pages as the largest buddy blocks that fit what is left, into scratch
+static void buddy_allocate(Memory *memory, int pages) {
+    int i, start, largest, left;
+    double fragmentation;
+    int order = memory->max_order;
+    int count = 0;
+
+    while (count < pages) {
+        while ((1 << order) > pages - count) {
+            order--;
+        }
+        start = buddy_take(memory, order);
+        // No block this large is free, so the rest is split into smaller ones
+        if (start < 0) {
+            order--;
+            continue;
+        }
+        for (i=start; i<start + (1 << order); i++) {
+            memory->pages[i / PAGES_PER_WORD] &= ~((uint64_t)1 << (i % PAGES_PER_WORD));
+            memory->scratch[count++] = i;
+        }
+    }
+    qsort(memory->scratch, count, sizeof(int), int_comp);
+
+    /* External fragmentation is the share of empty pages outside the largest
+       free block, and only means something while there are empty pages */
+    left = memory->empty_pages - pages;
+    if (left > 0) {
+        largest = largest_free_block(memory);
+        fragmentation = 100.0 * (left - largest) / left;
+        memory->frag_samples += 1;
+        memory->largest_free_total += largest;
+        if (largest < memory->largest_free_min) {
+            memory->largest_free_min = largest;
+        }
+        memory->frag_total += fragmentation;
+        if (fragmentation > memory->frag_max) {
+            memory->frag_max = fragmentation;
+        }
+    }
+}
+
+/* Switches memory to the buddy backend, which hands out each allocation as
+   power-of-two blocks, the largest first, so processes stay contiguous
+   where they can */
+void use_buddy(Memory *memory) {
+    int i, start = 0, order;
+
+    while ((2 << memory->max_order) <= memory->total_pages) {
+        memory->max_order++;
+    }
+    memory->free_heads = (int*)malloc((memory->max_order + 1)*sizeof(int));
+    memory->next_block = (int*)malloc(memory->total_pages*sizeof(int));
+    memory->prev_block = (int*)malloc(memory->total_pages*sizeof(int));
+    memory->block_order = (signed char*)malloc(memory->total_pages);
+    for (i=0; i<=memory->max_order; i++) {
+        memory->free_heads[i] = -1;
+    }
+    memset(memory->block_order, -1, memory->total_pages);
+
+    // Memory that isn't a power of two starts out as the largest aligned blocks that fit
+    while (start < memory->total_pages) {
+        order = memory->max_order;
+        while ((start % (1 << order) != 0) || (start + (1 << order) > memory->total_pages)) {
+            order--;
+        }
+        link_block(memory, start, order);
+        start += 1 << order;
+    }
+}
+
+// Returns the size in pages of the largest free buddy block
+int largest_free_block(Memory *memory) {
+    int order;
+
+    for (order=memory->max_order; order>=0; order--) {
+        if (memory->free_heads[order] >= 0) {
+            return 1 << order;
+        }
+    }
+    return 0;
+}
+
 // Allocate pages in memory to a process, and returns amount of pages allocated
 int allocate_memory(Memory *memory, Process *process, int pages) {
-    int i=0;
+    int i, word;
     int allocated_pages=0;
 
+    // Callers may ask for nothing, or less than nothing once a process holds its minimum
+    if (pages <= 0) {
+        return 0;
+    }
     if (memory->empty_pages < pages) {
         fprintf(stderr, "Trying to allocate more memory then there actually is\n");
         exit(1);
     }
 
-    while ((i < memory->total_pages) && (allocated_pages < pages)) {
-        if (memory->pages[i] == EMPTY) {
-            memory->pages[i] = OCCUPIED;
-            process->mem_index[process->pages_used] = i;
-            process->pages_used += 1;
-            memory->empty_pages -= 1;
+    PROFILE_START(PHASE_MEMORY);
+    if (memory->block_order != NULL) {
+        buddy_allocate(memory, pages);
+        allocated_pages = pages;
+    } else {
+        // Take the lowest empty pages first, skipping whole words that are full
+        word = memory->first_free;
+        while (allocated_pages < pages) {
+            while (memory->pages[word] == 0) {
+                word++;
+            }
+            memory->scratch[allocated_pages] = word*PAGES_PER_WORD
+                                               + __builtin_ctzll(memory->pages[word]);
+            // Clear the lowest set bit
+            memory->pages[word] &= memory->pages[word] - 1;
             allocated_pages += 1;
         }
-        i++;
+        memory->first_free = word;
     }
+    memory->empty_pages -= allocated_pages;
 
     if (allocated_pages > 0) {
+        // Reused processes keep their page list, so capacities go up in powers of two
+        if (process->mem_capacity < process->mem_req) {
+            process->mem_capacity = 1;
+            while (process->mem_capacity < process->mem_req) {
+                process->mem_capacity *= 2;
+            }
+            process->mem_index = (int*)arena_alloc(memory->page_lists,
+                                                   process->mem_capacity*sizeof(int));
+        }
+        // Freshly loaded pages count as referenced
+        if (memory->owners != NULL) {
+            for (i=0; i<allocated_pages; i++) {
+                memory->owners[memory->scratch[i]] = process;
+                memory->referenced[memory->scratch[i] / PAGES_PER_WORD] |=
+                    (uint64_t)1 << (memory->scratch[i] % PAGES_PER_WORD);
+            }
+        }
+        merge_pages(process, memory->scratch, allocated_pages);
+        memory->pages_loaded += allocated_pages;
+        if (is_resident(memory, process)) {
+            memory->resident_pages += allocated_pages;
+        }
         memory->total_processes += 1;
         memory->mem_usage = rounded_average((memory->total_pages - memory->empty_pages)*100,
                                              memory->total_pages);
     }
-
-    qsort(process->mem_index, process->mem_req, sizeof(int), page_comp);
+    PROFILE_COUNT(PROF_PAGE_FAULTS, allocated_pages);
+    PROFILE_STOP();
 
     return allocated_pages;
 }
 
-// Evicts amount of memory given by pages and returns the indexes of the evicted pages
+// Evicts the lowest pages held by a process and returns the indexes of the evicted pages
 int *evict_memory(Memory *memory, Process *process, int pages) {
-    int i=0;
+    int i;
+    int *lowest;
 
     if (pages == 0) {
         fprintf(stderr, "trying to allocate 0 pages");
         return NULL;
     }
 
+    PROFILE_START(PHASE_MEMORY);
     int *evicted_pages=(int*)malloc(pages*sizeof(int));
 
-    while (i < pages) {
-        if (process->mem_index[i] == NO_INDEX) {
-            fprintf(stderr, "Expected to evict more pages than there are\n");
-            break;
-        }
-        memory->pages[process->mem_index[i]] = EMPTY;
-        evicted_pages[i] = process->mem_index[i];
-        process->mem_index[i] = NO_INDEX;
-        process->pages_used -= 1;
-        memory->empty_pages += 1;
-        i++;
+    if (pages > process->pages_used) {
+        fprintf(stderr, "Expected to evict more pages than there are\n");
+        pages = process->pages_used;
     }
 
-    if (process->pages_used != 0) {
-        qsort(process->mem_index, process->mem_req, sizeof(int), page_comp);
+    // Held pages are kept sorted, so the lowest ones are simply dropped off the front
+    lowest = process->mem_index + process->mem_start;
+    for (i=0; i<pages; i++) {
+        free_page(memory, lowest[i]);
+        evicted_pages[i] = lowest[i];
+    }
+    if (is_resident(memory, process)) {
+        memory->resident_pages -= pages;
+    }
+    process->mem_start += pages;
+    process->pages_used -= pages;
+    process->next_reference = (process->next_reference > pages) ?
+                              process->next_reference - pages : 0;
+    memory->empty_pages += pages;
+    if (process->pages_used == 0) {
+        process->mem_start = 0;
+        // Nothing left to evict, so it stops being a victim
+        unlink_resident(memory, process);
     }
 
     memory->mem_usage = rounded_average((memory->total_pages - memory->empty_pages)*100,
                                          memory->total_pages);
+    PROFILE_STOP();
 
     return evicted_pages;
 }
 
+// Returns how many pages the given number of full rounds would evict
+static int rounds_evicted(Memory *memory, int rounds, int floor) {
+    int total = 0;
+    Process *victim;
+
+    for (victim = memory->least_recent; victim != NULL; victim = victim->next_resident) {
+        if (victim->pages_used - floor > rounds) {
+            total += rounds;
+        } else if (victim->pages_used > floor) {
+            total += victim->pages_used - floor;
+        }
+    }
+    return total;
+}
+
+/* Evicts pages from the residents in rounds of one page each, least recent
+   first, without taking any below floor pages. Stops as soon as pages have
+   been evicted, and returns how many were, recording them in evicted */
+int evict_evenly(Memory *memory, int pages, int floor, int *evicted) {
+    int low = 0, high = 0, mid, spare, take;
+    int count = 0;
+    int *curr_evicted;
+    Process *victim, *next;
+
+    PROFILE_START(PHASE_MEMORY);
+    // No resident can give more rounds than its spare pages
+    for (victim = memory->least_recent; victim != NULL; victim = victim->next_resident) {
+        if (victim->pages_used - floor > high) {
+            high = victim->pages_used - floor;
+        }
+    }
+    // Find the most full rounds that still leave pages to evict
+    while (low < high) {
+        mid = low + (high - low + 1) / 2;
+        if (rounds_evicted(memory, mid, floor) < pages) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    // The last, partial round only reaches the first spare residents
+    spare = pages - rounds_evicted(memory, low, floor);
+
+    victim = memory->least_recent;
+    while (victim != NULL) {
+        // Evicting every page takes the victim off the list
+        next = victim->next_resident;
+        take = victim->pages_used - floor;
+        if (take > low) {
+            take = low;
+            if (spare > 0) {
+                take += 1;
+                spare -= 1;
+            }
+        }
+        if (take > 0) {
+            curr_evicted = evict_memory(memory, victim, take);
+            memcpy(evicted + count, curr_evicted, take*sizeof(int));
+            count += take;
+            free(curr_evicted);
+        }
+        victim = next;
+    }
+    PROFILE_STOP();
+    return count;
+}
+
+// Starts keeping the reference bits and page owners the clock strategy needs
+void track_references(Memory *memory) {
+    memory->referenced = (uint64_t*)calloc(memory->map_words, sizeof(uint64_t));
+    memory->owners = (Process**)calloc(memory->total_pages, sizeof(Process*));
+}
+
+/* Models a process running for time units as touching one held page per
+   time unit, in order and wrapping around, and sets their reference bits */
+void reference_pages(Memory *memory, Process *process, int time) {
+    int i, page;
+    int *held = process->mem_index + process->mem_start;
+
+    if ((memory->owners == NULL) || (process->pages_used == 0)) {
+        return;
+    }
+    PROFILE_START(PHASE_MEMORY);
+    if (time > process->pages_used) {
+        time = process->pages_used;
+    }
+    for (i=0; i<time; i++) {
+        page = held[(process->next_reference + i) % process->pages_used];
+        memory->referenced[page / PAGES_PER_WORD] |= (uint64_t)1 << (page % PAGES_PER_WORD);
+    }
+    process->next_reference = (process->next_reference + time) % process->pages_used;
+    PROFILE_STOP();
+}
+
+// Evicts one particular page from the process holding it
+static void evict_page(Memory *memory, Process *process, int page) {
+    int low = 0, high = process->pages_used - 1, mid;
+    int *held = process->mem_index + process->mem_start;
+
+    // Held pages are sorted, so the page is found by bisection
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (held[mid] < page) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    memmove(held + low, held + low + 1, (process->pages_used - low - 1)*sizeof(int));
+    free_page(memory, page);
+    if (process->next_reference > low) {
+        process->next_reference -= 1;
+    }
+    if (is_resident(memory, process)) {
+        memory->resident_pages -= 1;
+    }
+    process->pages_used -= 1;
+    memory->empty_pages += 1;
+    if (process->pages_used == 0) {
+        process->mem_start = 0;
+        process->next_reference = 0;
+        unlink_resident(memory, process);
+    } else {
+        process->next_reference %= process->pages_used;
+    }
+    memory->mem_usage = rounded_average((memory->total_pages - memory->empty_pages)*100,
+                                         memory->total_pages);
+}
+
+/* Evicts pages of residents as the clock hand reaches them, passing over and
+   clearing referenced ones first. Returns how many were evicted, recording
+   them in evicted */
+int clock_evict(Memory *memory, int pages, int *evicted) {
+    int count = 0;
+    int page, word;
+    uint64_t bit;
+    Process *owner;
+
+    PROFILE_START(PHASE_MEMORY);
+    // Every resident page is reached within two turns of the hand
+    while ((count < pages) && (memory->resident_pages > 0)) {
+        page = memory->hand;
+        memory->hand = (memory->hand + 1) % memory->total_pages;
+        owner = memory->owners[page];
+        // Empty pages and those of running processes are passed over
+        if ((owner == NULL) || (!is_resident(memory, owner))) {
+            continue;
+        }
+        word = page / PAGES_PER_WORD;
+        bit = (uint64_t)1 << (page % PAGES_PER_WORD);
+        if (memory->referenced[word] & bit) {
+            memory->referenced[word] &= ~bit;
+            continue;
+        }
+        evict_page(memory, owner, page);
+        evicted[count++] = page;
+    }
+    PROFILE_STOP();
+    return count;
+}
+
+// Takes a process out of the resident list, if it is in there
+void unlink_resident(Memory *memory, Process *process) {
+    if (!is_resident(memory, process)) {
+        return;
+    }
+    memory->resident_pages -= process->pages_used;
+    if (process->prev_resident == NULL) {
+        memory->least_recent = process->next_resident;
+    } else {
+        process->prev_resident->next_resident = process->next_resident;
+    }
+    if (process->next_resident == NULL) {
+        memory->most_recent = process->prev_resident;
+    } else {
+        process->next_resident->prev_resident = process->prev_resident;
+    }
+    process->prev_resident = NULL;
+    process->next_resident = NULL;
+}
+
+// Adds a loaded process to the resident list as the most recently executed
+void append_resident(Memory *memory, Process *process) {
+    if (process->pages_used == 0) {
+        return;
+    }
+    process->prev_resident = memory->most_recent;
+    process->next_resident = NULL;
+    if (memory->most_recent == NULL) {
+        memory->least_recent = process;
+    } else {
+        memory->most_recent->next_resident = process;
+    }
+    memory->most_recent = process;
+    memory->resident_pages += process->pages_used;
+}
+
+// Marks a single page as empty again
+void free_page(Memory *memory, int page) {
+    int word = page / PAGES_PER_WORD;
+
+    PROFILE_COUNT(PROF_EVICTIONS, 1);
+    memory->pages[word] |= (uint64_t)1 << (page % PAGES_PER_WORD);
+    if (word < memory->first_free) {
+        memory->first_free = word;
+    }
+    if (memory->owners != NULL) {
+        memory->owners[page] = NULL;
+        memory->referenced[word] &= ~((uint64_t)1 << (page % PAGES_PER_WORD));
+    }
+    if (memory->block_order != NULL) {
+        buddy_free(memory, page);
+    }
+}
+
 // Typical ascending sort comparator, but moves -1 to the back
 int page_comp(const void *first, const void *second) {
     int *x, *y;
@@ -98,7 +564,15 @@ int page_comp(const void *first, const void *second) {
 }
 
 void free_memory(Memory *memory) {
+    free(memory->referenced);
+    free(memory->owners);
+    free(memory->free_heads);
+    free(memory->next_block);
+    free(memory->prev_block);
+    free(memory->block_order);
     free(memory->pages);
+    free(memory->scratch);
+    free_arena(memory->page_lists);
     free(memory);
 }
 
@@ -125,18 +599,12 @@ int allocate_all(Memory *memory, Process *process) {
     return load_time;
 }
 
-// Implements heuristic to decide how much memory should be allocated
-int fair_alloc(Memory *memory, Deque *deque, Process *process, int min_pages) {
+/* Implements heuristic to decide how much memory should be allocated, given the
+   total remaining time of the processes left waiting */
+int fair_alloc(Memory *memory, long waiting_time, Process *process, int min_pages) {
 	float time_proportion;
 	int heuristic;
-	int total_time=process->remaining_time;
-	Node *curr = deque->head;
-
-	// Get total remaining time
-	while (curr != NULL) {
-		total_time += curr->process->remaining_time;
-		curr = curr->next;
-	}
+	long total_time = process->remaining_time + waiting_time;
 
 	time_proportion = (float)process->remaining_time / total_time;
 
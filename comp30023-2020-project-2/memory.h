@@ -1,21 +1,47 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 #define KB_PER_PAGE 4
-#define EMPTY 0
-#define OCCUPIED 1
+#define PAGES_PER_WORD 64
 #define MIN_MEM_REQ 4
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include "process-deque.h"
 #include "statistics.h"
+#include "arena.h"
 
 
 typedef struct memory Memory;
 
 struct memory {
-    int *pages;
+    uint64_t *pages; // Bitmap with a set bit for every empty page
+    int map_words;
+    int first_free; // No empty pages exist in words before this one
+    int *scratch; // Holds newly allocated pages before they are merged into a process
+    Arena *page_lists; // Backs the mem_index of every process that has been loaded
+    // Processes holding pages, from least to most recently executed
+    Process *least_recent;
+    Process *most_recent;
+    int resident_pages; // Pages held by the processes in the resident list
+    // Only kept for the clock strategy, NULL otherwise
+    uint64_t *referenced; // Bitmap with a set bit for every page referenced since the hand passed
+    Process **owners; // Process holding each page
+    int hand; // Next page the clock hand looks at
+    long pages_loaded;
+    // Buddy backend, block_order is NULL while pages are taken singly from the bitmap
+    int max_order;
+    int *free_heads; // First free block of each order, -1 if there is none
+    int *next_block; // Links of the free lists, indexed by the first page of a block
+    int *prev_block;
+    signed char *block_order; // Order of the free block starting at each page, -1 if none
+    // Sampled after every allocation the buddy backend makes
+    long frag_samples;
+    long largest_free_total;
+    int largest_free_min;
+    double frag_total;
+    double frag_max;
     int total_pages;
     int empty_pages;
     int total_processes;
@@ -26,15 +52,41 @@ struct memory {
 Memory *init_memory(int mem_size);
 // Allocate pages in memory to a process, and returns amount of pages allocated
 int allocate_memory(Memory *memory, Process *process, int pages);
-// Evicts amount of memory given by pages and returns the indexes of the evicted pages
+// Evicts the lowest pages held by a process and returns the indexes of the evicted pages
 int *evict_memory(Memory *memory, Process *process, int pages);
+/* Evicts pages from the residents in rounds of one page each, least recent
+   first, without taking any below floor pages. Stops as soon as pages have
+   been evicted, and returns how many were, recording them in evicted */
+int evict_evenly(Memory *memory, int pages, int floor, int *evicted);
+/* Switches memory to the buddy backend, which hands out each allocation as
+   power-of-two blocks, the largest first, so processes stay contiguous
+   where they can */
+void use_buddy(Memory *memory);
+// Returns the size in pages of the largest free buddy block
+int largest_free_block(Memory *memory);
+// Starts keeping the reference bits and page owners the clock strategy needs
+void track_references(Memory *memory);
+/* Models a process running for time units as touching one held page per
+   time unit, in order and wrapping around, and sets their reference bits */
+void reference_pages(Memory *memory, Process *process, int time);
+/* Evicts pages of residents as the clock hand reaches them, passing over and
+   clearing referenced ones first. Returns how many were evicted, recording
+   them in evicted */
+int clock_evict(Memory *memory, int pages, int *evicted);
+// Takes a process out of the resident list, if it is in there
+void unlink_resident(Memory *memory, Process *process);
+// Adds a loaded process to the resident list as the most recently executed
+void append_resident(Memory *memory, Process *process);
+// Marks a single page as empty again
+void free_page(Memory *memory, int page);
 // Typical ascending sort comparator, but moves -1 to the back
 int page_comp(const void *first, const void *second);
 void free_memory(Memory *memory);
 int get_min_pages(Process *process);
 // Allocates as many pages of a process as possible
 int allocate_all(Memory *memory, Process *process);
-// Implements heuristic to decide how much memory should be allocated
-int fair_alloc(Memory *memory, Deque *deque, Process *process, int min_pages);
+/* Implements heuristic to decide how much memory should be allocated, given the
+   total remaining time of the processes left waiting */
+int fair_alloc(Memory *memory, long waiting_time, Process *process, int min_pages);
 
 #endif
@@ -0,0 +1,254 @@
+#include "scheduler.h"
+
+
+// Adds a process to the back of a core's ready queue
+static void enqueue(Machine *machine, Core *core, Process *process) {
+    deque_append(core->queue, process);
+    if (core->ready != NULL) {
+        heap_fill(core->ready);
+    }
+    machine->queued += 1;
+}
+
+// Returns the number of processes queued on or running on a core
+static int core_load(Core *core) {
+    return deque_size(core->queue) + ((core->curr != NULL) ? 1 : 0);
+}
+
+// Returns the total remaining time of the processes waiting over every core's queue
+static long queued_remaining(Machine *machine) {
+    int i;
+    long total = 0;
+
+    for (i=0; i<machine->num_cores; i++) {
+        total += deque_total_remaining(machine->cores[i].queue);
+    }
+    return total;
+}
+
+// Sends an arrival to the least loaded core
+static void place(Machine *machine, Process *process) {
+    int i, best = 0;
+
+    for (i=1; i<machine->num_cores; i++) {
+        if (core_load(&machine->cores[i]) < core_load(&machine->cores[best])) {
+            best = i;
+        }
+    }
+    enqueue(machine, &machine->cores[best], process);
+}
+
+// Checks whether memory can be made for a process without touching running ones
+static int fits(Machine *machine, Process *process) {
+    int needed;
+    Memory *memory = machine->memory;
+
+    if (machine->mem_strat == NULL) {
+        return 1;
+    }
+    // Swapping loads whole processes, the others only need a few pages
+    if (machine->mem_strat == swapping) {
+        needed = process->mem_req - process->pages_used;
+    } else {
+        needed = get_min_pages(process);
+    }
+    return needed <= memory->empty_pages + memory->resident_pages;
+}
+
+// Loads a process onto an idle core and schedules the end of its slice
+static void start(Machine *machine, int i, int clock, Process *process) {
+    int load_time = 0;
+    int slice;
+    Core *core = &machine->cores[i];
+
+    if (machine->mem_strat != NULL) {
+        load_time = (*machine->mem_strat)(clock, machine->memory, queued_remaining(machine),
+                                           process);
+        // Running processes are out of reach of evictions made by other cores
+        unlink_resident(machine->memory, process);
+    }
+    print_execution(clock, process, load_time, machine->memory->mem_usage, i);
+    update_dispatch_stats(clock, machine->stats, load_time, machine->memory->mem_usage,
+                          machine->queued);
+
+    if (!machine->rotate) {
+        slice = process->job_time;
+        core->finishing = 1;
+    } else if (process->remaining_time <= machine->quantum) {
+        slice = process->remaining_time;
+        core->finishing = 1;
+    } else {
+        slice = machine->quantum;
+        core->finishing = 0;
+    }
+    core->curr = process;
+    core->slice_end = clock + slice + load_time;
+    machine->stats->core_busy[i] += slice + load_time;
+    machine->running += 1;
+}
+
+// Finishes the slice of core i, either completing its process or queueing it again
+static void end_slice(Machine *machine, int i, int clock) {
+    int num_evicted;
+    int *evicted_pages;
+    Core *core = &machine->cores[i];
+    Process *curr = core->curr;
+
+    core->curr = NULL;
+    machine->running -= 1;
+    if (core->finishing) {
+        if (machine->mem_strat != NULL) {
+            num_evicted = curr->pages_used;
+            evicted_pages = evict_memory(machine->memory, curr, num_evicted);
+            print_evicted(clock, evicted_pages, num_evicted);
+            free(evicted_pages);
+        }
+        update_stats(clock, machine->stats, curr);
+        print_finishing(clock, curr->pid, machine->queued, i);
+        release_process(machine->trace, curr);
+    } else { // Quantum elapsed, process goes to the back of the same core
+        curr->remaining_time -= machine->quantum;
+        reference_pages(machine->memory, curr, machine->quantum);
+        if (machine->mem_strat != NULL) {
+            append_resident(machine->memory, curr);
+        }
+        enqueue(machine, core, curr);
+    }
+}
+
+// Returns the next process of a core without removing it, or NULL if none
+static Process *peek(Core *core) {
+    if (deque_null(core->queue)) {
+        return NULL;
+    }
+    return deque_get(core->queue, 0);
+}
+
+// Removes the next process of a core
+static Process *take(Machine *machine, Core *core) {
+    machine->queued -= 1;
+    if (core->ready != NULL) {
+        return heap_pop(core->ready);
+    }
+    return deque_pop(core->queue);
+}
+
+// Removes a process from the back of the longest other queue if it can be loaded, or returns NULL
+static Process *steal(Machine *machine, int thief) {
+    int i, victim = -1;
+    Core *core;
+    Process *process;
+
+    for (i=0; i<machine->num_cores; i++) {
+        if ((i != thief) && ((victim < 0) || (deque_size(machine->cores[i].queue) >
+                                              deque_size(machine->cores[victim].queue)))) {
+            victim = i;
+        }
+    }
+    if (victim < 0) {
+        return NULL;
+    }
+    core = &machine->cores[victim];
+    if (deque_null(core->queue)) {
+        return NULL;
+    }
+    // The back of a heap is a leaf, so taking it keeps the victim in order
+    process = deque_get(core->queue, deque_size(core->queue) - 1);
+    if (!fits(machine, process)) {
+        return NULL;
+    }
+    machine->queued -= 1;
+    if (core->ready != NULL) {
+        return heap_remove(core->ready);
+    }
+    return deque_remove(core->queue);
+}
+
+// Simulates process_list over num_cores cores and returns the time the last process finished
+int multicore(Trace *process_list, char *sched_alg, int quantum, int num_cores,
+              Statistics *stats, Memory *memory,
+              int (*mem_strat)(int, Memory*, long, Process*))
+{
+    int clock = 0;
+    int i, next;
+    Process *process;
+    Deque *arrived = new_deque();
+    Machine machine;
+
+    machine.num_cores = num_cores;
+    machine.quantum = quantum;
+    machine.rotate = !strcmp(sched_alg, "rr");
+    machine.queued = 0;
+    machine.running = 0;
+    machine.stats = stats;
+    machine.memory = memory;
+    machine.trace = process_list;
+    machine.mem_strat = mem_strat;
+    machine.cores = (Core*)malloc(num_cores*sizeof(Core));
+    for (i=0; i<num_cores; i++) {
+        machine.cores[i].queue = new_deque();
+        machine.cores[i].ready = NULL;
+        if (!strcmp(sched_alg, "cs")) {
+            machine.cores[i].ready = new_heap(machine.cores[i].queue);
+        }
+        machine.cores[i].curr = NULL;
+    }
+
+    while (!out_of_time(stats, clock)) {
+        // Arrivals are placed before preempted processes rejoin, as on one core
+        update_deque(clock, process_list, arrived);
+        while (!deque_null(arrived)) {
+            place(&machine, deque_pop(arrived));
+        }
+        for (i=0; i<num_cores; i++) {
+            if ((machine.cores[i].curr != NULL) && (machine.cores[i].slice_end == clock)) {
+                end_slice(&machine, i, clock);
+            }
+        }
+
+        // Idle cores run their own queue first, and only then steal
+        for (i=0; i<num_cores; i++) {
+            process = peek(&machine.cores[i]);
+            if ((machine.cores[i].curr == NULL) && (process != NULL) &&
+                (fits(&machine, process))) {
+                start(&machine, i, clock, take(&machine, &machine.cores[i]));
+            }
+        }
+        for (i=0; i<num_cores; i++) {
+            if ((machine.cores[i].curr == NULL) && ((process = steal(&machine, i)) != NULL)) {
+                start(&machine, i, clock, process);
+            }
+        }
+
+        // Jump straight to the next slice end or arrival
+        next = -1;
+        for (i=0; i<num_cores; i++) {
+            if ((machine.cores[i].curr != NULL) &&
+                ((next < 0) || (machine.cores[i].slice_end < next))) {
+                next = machine.cores[i].slice_end;
+            }
+        }
+        if ((!trace_done(process_list)) &&
+            ((next < 0) || (next_arrival(process_list) < next))) {
+            next = next_arrival(process_list);
+        }
+        if (next < 0) {
+            if (machine.queued > 0) {
+                fprintf(stderr, "Queued processes can never fit in memory\n");
+                exit(1);
+            }
+            break;
+        }
+        clock = next;
+    }
+
+    for (i=0; i<num_cores; i++) {
+        if (machine.cores[i].ready != NULL) {
+            free_heap(machine.cores[i].ready);
+        }
+        free_deque(machine.cores[i].queue);
+    }
+    free(machine.cores);
+    free_deque(arrived);
+    return clock;
+}
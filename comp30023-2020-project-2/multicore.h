@@ -0,0 +1,49 @@
+#ifndef MULTICORE_H
+#define MULTICORE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "statistics.h"
+#include "memory.h"
+#include "process-heap.h"
+#include "trace.h"
+
+/* Simulates the ff, rr and cs policies over several cores sharing one
+   memory. Every core keeps its own ready queue: arrivals join the core with
+   the fewest processes queued or running, preempted processes go back to
+   the core they ran on, and a core left with nothing to run steals from the
+   back of the longest queue. Memory strategies are given the total remaining
+   time of the processes waiting over every queue, not counting running ones,
+   so cm's fair share is taken over the whole machine as on one core. */
+
+typedef struct core Core;
+typedef struct machine Machine;
+
+struct core {
+    Deque *queue;
+    Heap *ready; // Orders queue by job time under cs, NULL otherwise
+    Process *curr; // NULL while idle
+    int slice_end;
+    int finishing; // Whether curr completes at slice_end
+};
+
+struct machine {
+    Core *cores;
+    int num_cores;
+    int quantum; // Only used by rr, the other policies run jobs to completion
+    int rotate;
+    int queued; // Processes waiting over every queue
+    int running;
+    Statistics *stats;
+    Memory *memory;
+    Trace *trace; // Takes back finished processes
+    int (*mem_strat)(int, Memory*, long, Process*);
+};
+
+// Simulates process_list over num_cores cores and returns the time the last process finished
+int multicore(Trace *process_list, char *sched_alg, int quantum, int num_cores,
+              Statistics *stats, Memory *memory,
+              int (*mem_strat)(int, Memory*, long, Process*));
+
+#endif
@@ -0,0 +1,110 @@
+/* Buffered event log writer */
+#include "output.h"
+
+
+int quiet = 0;
+
+static char buffer[OUTPUT_BUFF];
+Output standard_output = {buffer, 0, OUTPUT_BUFF, STDOUT_FILENO};
+
+// Writes length bytes of text to fd, retrying partial writes
+void write_all(int fd, const char *text, size_t length) {
+    size_t written=0;
+    ssize_t result;
+
+    while (written < length) {
+        result = write(fd, text + written, length - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("write");
+            exit(1);
+        }
+        written += result;
+    }
+}
+
+// Writes out or grows a buffer until length more bytes fit, if they ever can
+static void make_room(Output *out, size_t length) {
+    if (out->used + length <= out->capacity) {
+        return;
+    }
+    if (out->fd >= 0) {
+        write_all(out->fd, out->buffer, out->used);
+        out->used = 0;
+        return;
+    }
+    while (out->used + length > out->capacity) {
+        out->capacity *= 2;
+    }
+    out->buffer = (char*)realloc(out->buffer, out->capacity);
+    if (out->buffer == NULL) {
+        fprintf(stderr, "Out of memory for output\n");
+        exit(1);
+    }
+}
+
+// Appends a null terminated string to a buffer
+void buffer_str(Output *out, const char *str) {
+    size_t length = strlen(str);
+
+    make_room(out, length);
+    // Too long to ever fit, send it through in buffer sized pieces
+    while (out->used + length > out->capacity) {
+        memcpy(out->buffer, str, out->capacity);
+        out->used = out->capacity;
+        str += out->capacity;
+        length -= out->capacity;
+        make_room(out, length);
+    }
+    memcpy(out->buffer + out->used, str, length);
+    out->used += length;
+}
+
+// Appends the decimal form of value to a buffer
+void buffer_int(Output *out, long value) {
+    char digits[INT_DIGITS];
+    int i = INT_DIGITS;
+    unsigned long magnitude;
+
+    make_room(out, INT_DIGITS + 1);
+    magnitude = (value < 0) ? -(unsigned long)value : (unsigned long)value;
+    // Digits come out least significant first, so fill from the back
+    do {
+        digits[--i] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        out->buffer[out->used++] = '-';
+    }
+    memcpy(out->buffer + out->used, digits + i, INT_DIGITS - i);
+    out->used += INT_DIGITS - i;
+}
+
+// Appends a single character to a buffer
+void buffer_char(Output *out, char c) {
+    make_room(out, 1);
+    out->buffer[out->used++] = c;
+}
+
+// Writes out everything buffered so far
+void flush_output() {
+    write_all(standard_output.fd, standard_output.buffer, standard_output.used);
+    standard_output.used = 0;
+}
+
+// Appends a null terminated string to the output buffer
+void output_str(const char *str) {
+    buffer_str(&standard_output, str);
+}
+
+// Appends the decimal form of value to the output buffer
+void output_int(long value) {
+    buffer_int(&standard_output, value);
+}
+
+// Appends a single character to the output buffer
+void output_char(char c) {
+    buffer_char(&standard_output, c);
+}
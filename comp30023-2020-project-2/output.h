@@ -0,0 +1,55 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+#define OUTPUT_BUFF (1 << 16)
+#define INT_DIGITS 20
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+/* Buffered text writers. Text collects in a user-space buffer and leaves
+   in a single write(2) whenever the buffer fills or is flushed. A buffer
+   without a file descriptor grows instead, holding text for later. */
+
+typedef struct output Output;
+
+struct output {
+    char *buffer;
+    size_t used;
+    size_t capacity;
+    int fd; // Where a full buffer is written, or -1 to grow it
+};
+
+// Set to skip the event log, leaving only the performance summary
+extern int quiet;
+
+// The buffer in front of stdout
+extern Output standard_output;
+
+// Appends a null terminated string to a buffer
+void buffer_str(Output *out, const char *str);
+
+// Appends the decimal form of value to a buffer
+void buffer_int(Output *out, long value);
+
+// Appends a single character to a buffer
+void buffer_char(Output *out, char c);
+
+// Writes length bytes of text to fd, retrying partial writes
+void write_all(int fd, const char *text, size_t length);
+
+// Appends a null terminated string to the output buffer
+void output_str(const char *str);
+
+// Appends the decimal form of value to the output buffer
+void output_int(long value);
+
+// Appends a single character to the output buffer
+void output_char(char c);
+
+// Writes out everything buffered so far
+void flush_output();
+
+#endif
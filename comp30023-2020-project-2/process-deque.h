@@ -1,19 +1,15 @@
 #ifndef PROCESS_DEQUE
 #define PROCESS_DEQUE
-#define ARRIVED 0
-#define ID 1
-#define MEM_REQ 2
-#define JOB_TIME 3
-#define NO_INDEX -1
+#define INITIAL_CAPACITY 16
 
 #include <stdio.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include "profile.h"
 
 typedef struct process Process;
-typedef struct node Node;
 typedef struct deque Deque;
 
 struct process {
@@ -22,21 +18,26 @@ struct process {
     int mem_req; // Given in pages required
     int job_time;
     int remaining_time;
-    int *mem_index;
+    int *mem_index; // Pages held, sorted from mem_index[mem_start]
+    int mem_capacity; // Pages mem_index has room for
+    int mem_start;
     int pages_used;
+    int arrival_order; // Position in the arrival sequence, breaks ties between equal priorities
+    int next_reference; // Held page the clock strategy's reference model touches next
+    Process *prev_resident; // Neighbours in the Memory's least recently executed list
+    Process *next_resident; // Also chains finished processes kept for reuse
 };
 
-struct node {
-    Process *process;
-    Node *prev;
-    Node *next;
-};
-
-
+// Ring buffer of processes, the top process sits in slot first
 struct deque {
+    Process **processes;
+    int capacity; // Always a power of two
+    int first;
     int size;
-    Node *head;
-    Node *foot;
+    /* Sum of remaining_time over the queued processes. Only valid while
+       queued processes keep their remaining_time, the scheduler changes it
+       between popping and re-queueing a process */
+    long total_remaining;
 };
 
 #include "memory.h"
@@ -44,7 +45,7 @@ struct deque {
 // Create a new empty Deque and return a pointer to it
 Deque *new_deque();
 
-// Free the memory associated with a Deque
+// Free the memory associated with a Deque, processes belong to their Arena
 void free_deque(Deque *deque);
 
 // Add a process to the top of a Deque
@@ -59,40 +60,22 @@ Process* deque_pop(Deque *deque);
 // Remove and return the bottom process from a Deque
 Process* deque_remove(Deque *deque);
 
+// Return the process i places from the top of a Deque
+Process* deque_get(Deque *deque, int i);
+
+// Replace the process i places from the top of a Deque
+void deque_set(Deque *deque, int i, Process *process);
+
 // Return the number of process in a Deque
 int deque_size(Deque *deque);
 
 // Checks whether deque's elements are empty
 int deque_null(Deque* deque);
 
-// Creates a new empty node and returns a pointer to it
-Node* new_node(Process* process);
-
-// Resets deque to null values
-void reset_deque(Deque* deque);
-
-// Deals with the initial case where list only has one node
-void deque_initial(Deque* deque, Node* node);
-
-// Creates and returns new process derived from process_line
-Process* new_process(char* process_line);
-
-// Frees memory associated with process
-void free_process(Process* process);
-
-// Appends a process from process_list to arrived at the appropriate time
-void update_deque(int clock, Deque *process_list, Deque *arrived);
-
-// Resolve order of same-time process arrivals by process id
-void order_deque(Deque *deque);
-
-// Inserts Node curr before insert_at and returns the Node after curr
-Node *insert_before(Deque *deque, Node *curr_node, Node *insert_at);
-
-// Returns a pointer to the least recently executed process
-Node *get_least_recent(Deque *deque);
+// Returns the total remaining time of every process in a Deque
+long deque_total_remaining(Deque *deque);
 
-// Implements a priority queue using insertion sort based on job time
-void prioritise(Deque *deque);
+// Doubles the capacity of a Deque, unwrapping it so the top sits in slot 0
+void grow_deque(Deque *deque);
 
 #endif
@@ -0,0 +1,112 @@
+/* Binary min-heap over the slots of a Deque, used as the shortest first ready queue */
+#include "process-heap.h"
+
+
+// Returns whether process a should be served before process b
+static int heap_before(Heap *heap, Process *a, Process *b) {
+	if ((heap->key == BY_REMAINING) && (a->remaining_time != b->remaining_time)) {
+		return a->remaining_time < b->remaining_time;
+	}
+	if ((heap->key == BY_JOB_TIME) && (a->job_time != b->job_time)) {
+		return a->job_time < b->job_time;
+	}
+	return a->arrival_order < b->arrival_order;
+}
+
+// Create a new Heap ordering the processes of queue and return a pointer to it
+Heap *new_heap(Deque *queue) {
+	Heap *heap = (Heap*)malloc(sizeof(Heap));
+	heap->queue = queue;
+	heap->size = 0;
+	heap->key = BY_JOB_TIME;
+	return heap;
+}
+
+// Create a new Heap ordering the processes of queue by remaining time instead of job time
+Heap *new_remaining_heap(Deque *queue) {
+	Heap *heap = new_heap(queue);
+	heap->key = BY_REMAINING;
+	return heap;
+}
+
+// Free the memory associated with a Heap, the processes stay in their Deque
+void free_heap(Heap *heap) {
+	free(heap);
+	return;
+}
+
+// Moves the process at slot i up until its parent comes before it
+static void sift_up(Heap *heap, int i) {
+	int parent;
+	Deque *queue = heap->queue;
+	Process *rising = deque_get(queue, i);
+
+	while (i > 0) {
+		parent = (i - 1) / 2;
+		if (!heap_before(heap, rising, deque_get(queue, parent))) {
+			break;
+		}
+		deque_set(queue, i, deque_get(queue, parent));
+		i = parent;
+	}
+	deque_set(queue, i, rising);
+}
+
+// Remove and return the process with the shortest job time, ties go to the earliest arrival
+Process *heap_pop(Heap *heap) {
+	int i=0, child;
+	Deque *queue = heap->queue;
+	Process *top = deque_get(queue, 0);
+	Process *sinking;
+
+	PROFILE_START(PHASE_QUEUE);
+	sinking = deque_remove(queue);
+	heap->size -= 1;
+	if (heap->size == 0) {
+		PROFILE_STOP();
+		return top;
+	}
+
+	// Sift the old bottom process down from the top slot
+	while ((child = 2*i + 1) < heap->size) {
+		if ((child + 1 < heap->size) &&
+		    (heap_before(heap, deque_get(queue, child+1), deque_get(queue, child)))) {
+			child += 1;
+		}
+		if (!heap_before(heap, deque_get(queue, child), sinking)) {
+			break;
+		}
+		deque_set(queue, i, deque_get(queue, child));
+		i = child;
+	}
+	deque_set(queue, i, sinking);
+	PROFILE_STOP();
+	return top;
+}
+
+// Return the process heap_pop() would remove, without removing it
+Process *heap_peek(Heap *heap) {
+	return deque_get(heap->queue, 0);
+}
+
+// Remove and return the bottom process, which leaves the rest in heap order
+Process *heap_remove(Heap *heap) {
+	heap->size -= 1;
+	return deque_remove(heap->queue);
+}
+
+// Checks whether heap's elements are empty
+int heap_null(Heap *heap) {
+	return (heap->size == 0) ? 1 : 0;
+}
+
+// Sifts every process appended to the queue since the last call into place
+void heap_fill(Heap *heap) {
+	PROFILE_START(PHASE_QUEUE);
+	while (heap->size < heap->queue->size) {
+		sift_up(heap, heap->size);
+		heap->size += 1;
+	}
+	PROFILE_STOP();
+	return;
+}
@@ -0,0 +1,43 @@
+#ifndef PROCESS_HEAP
+#define PROCESS_HEAP
+#define BY_JOB_TIME 0
+#define BY_REMAINING 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "process-deque.h"
+
+typedef struct heap Heap;
+
+// Binary min-heap laid out in place over the slots of a Deque
+struct heap {
+    Deque *queue;
+    int size; // Leading processes of queue that are already in heap order
+    int key; // BY_JOB_TIME or BY_REMAINING
+};
+
+// Create a new Heap ordering the processes of queue and return a pointer to it
+Heap *new_heap(Deque *queue);
+
+// Create a new Heap ordering the processes of queue by remaining time instead of job time
+Heap *new_remaining_heap(Deque *queue);
+
+// Free the memory associated with a Heap, the processes stay in their Deque
+void free_heap(Heap *heap);
+
+// Remove and return the process with the shortest job time, ties go to the earliest arrival
+Process *heap_pop(Heap *heap);
+
+// Return the process heap_pop() would remove, without removing it
+Process *heap_peek(Heap *heap);
+
+// Remove and return the bottom process, which leaves the rest in heap order
+Process *heap_remove(Heap *heap);
+
+// Checks whether heap's elements are empty
+int heap_null(Heap *heap);
+
+// Sifts every process appended to the queue since the last call into place
+void heap_fill(Heap *heap);
+
+#endif
@@ -0,0 +1,37 @@
+/* Counters and per-phase timers for finding where a simulation spends its time */
+#include "profile.h"
+
+_Thread_local Profile profile;
+
+
+static long long now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1000000000LL + ts.tv_nsec;
+}
+
+// Charges the time since the last start or stop to the innermost open phase
+static void charge() {
+    long long now = now_ns();
+
+    if (profile.depth > 0) {
+        profile.phase_ns[profile.phases[profile.depth - 1]] += now - profile.since;
+    }
+    profile.since = now;
+}
+
+// Opens a phase inside the current one, pausing the current one's timer
+void profile_start(int phase) {
+    charge();
+    if (profile.depth == MAX_PHASE_DEPTH) {
+        fprintf(stderr, "Profile phases nested too deeply\n");
+        exit(1);
+    }
+    profile.phases[profile.depth++] = phase;
+}
+
+// Closes the innermost phase, resuming the timer of the one around it
+void profile_stop() {
+    charge();
+    profile.depth--;
+}
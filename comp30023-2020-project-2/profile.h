@@ -0,0 +1,53 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+#define PROF_PAGE_FAULTS 0
+#define PROF_EVICTIONS 1
+#define PROF_DEQUE_VISITS 2
+#define PROF_SWITCHES 3
+#define NUM_COUNTERS 4
+#define PHASE_SCHEDULING 0 // Everything in a simulation outside the other phases
+#define PHASE_QUEUE 1
+#define PHASE_MEMORY 2
+#define PHASE_OUTPUT 3
+#define NUM_PHASES 4
+#define MAX_PHASE_DEPTH 8
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Hot path instrumentation, only compiled in with -DPROFILE (make PROFILE=1).
+   Without it the macros below expand to nothing, so instrumented code costs
+   exactly what it did before. Counters and phase timers are kept per thread,
+   so sweep threads never share them. Phases nest, and time is charged to the
+   innermost phase only, so the phases add up to the whole simulation. */
+
+typedef struct profile Profile;
+
+struct profile {
+    long counters[NUM_COUNTERS];
+    long long phase_ns[NUM_PHASES];
+    int phases[MAX_PHASE_DEPTH]; // Open phases, innermost last
+    int depth;
+    long long since; // When the innermost phase was last charged
+};
+
+extern _Thread_local Profile profile;
+
+#ifdef PROFILE
+#define PROFILE_COUNT(counter, n) (profile.counters[(counter)] += (n))
+#define PROFILE_START(phase) profile_start(phase)
+#define PROFILE_STOP() profile_stop()
+#else
+#define PROFILE_COUNT(counter, n) ((void)0)
+#define PROFILE_START(phase) ((void)0)
+#define PROFILE_STOP() ((void)0)
+#endif
+
+// Opens a phase inside the current one, pausing the current one's timer
+void profile_start(int phase);
+
+// Closes the innermost phase, resuming the timer of the one around it
+void profile_stop();
+
+#endif
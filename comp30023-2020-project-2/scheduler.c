@@ -4,15 +4,80 @@
 int main(int argc, char **argv)
 {
     int opt;
-    int optionals[NUM_OPTIONAL];
-    char *filename, *sched_alg, *mem_alloc;
+    int sweeping=0, streaming=0, reading_ahead=0, profiling=0, threads=0, limit=-1;
+    int log_threads=0;
+    int num_quanta=0, levels_given=0;
+    int optionals[NUM_OPTIONAL] = {0, 10, 1, DEFAULT_LEVELS, 0};
+    char *filename=NULL, *sched_alg=NULL, *mem_alloc=NULL, *series_file=NULL;
+    char *mem_sizes=NULL, *quanta=NULL, *cores=NULL, *level_quantum;
+    Checkpoint checkpoint = {NULL, 0, 0, NULL, NULL, NULL};
 
-    /* Flags: -f filename -a scheduling-alg {ff, rr, cs}
-              -m memory-allocation {u,p,v,cm}
+    struct option long_options[] = {
+        {"quiet", no_argument, NULL, QUIET_OPT},
+        {"sweep", no_argument, NULL, SWEEP_OPT},
+        {"stream", no_argument, NULL, STREAM_OPT},
+        {"levels", required_argument, NULL, LEVELS_OPT},
+        {"quanta", required_argument, NULL, QUANTA_OPT},
+        {"boost", required_argument, NULL, BOOST_OPT},
+        {"buddy", no_argument, NULL, BUDDY_OPT},
+        {"profile", no_argument, NULL, PROFILE_OPT},
+        {"series", required_argument, NULL, SERIES_OPT},
+        {"percentiles", no_argument, NULL, PERCENTILES_OPT},
+        {"checkpoint", required_argument, NULL, CHECKPOINT_OPT},
+        {"checkpoint-at", required_argument, NULL, CHECKPOINT_AT_OPT},
+        {"restore", required_argument, NULL, RESTORE_OPT},
+        {"limit", required_argument, NULL, LIMIT_OPT},
+        {"log-threads", required_argument, NULL, LOG_THREADS_OPT},
+        {"read-ahead", no_argument, NULL, READ_AHEAD_OPT},
+        {0, 0, 0, 0}
+    };
+
+    /* Flags: -f filename -a scheduling-alg {ff, rr, cs, mlfq, srtf}
+              -m memory-allocation {u,p,v,cm,clock}
               OPTIONAL: -s memory-size
-                        -q quantum for rr               */
+                        -q quantum for rr
+                        -c number of cores, each with its own ready queue
+                        --quiet skips the event log
+                        --log-threads threads rendering the event log
+                        --stream reads the trace as processes arrive,
+                                 from stdin if the filename is -
+                        --read-ahead streams the trace with a thread of
+                                     its own reading and ordering arrivals
+                                     ahead of the simulation
+                        --levels number of mlfq levels
+                        --quanta comma separated quantum of each mlfq
+                                 level, later levels double the last one.
+                                 Also sets the levels unless --levels does
+                        --boost interval between moving every mlfq
+                                process to the top level, 0 never does
+                        --buddy allocates limited memory from a buddy
+                                system instead of page by page
+                        --profile prints the instrumentation counters and
+                                  phase timers after the summary, in
+                                  builds made with make PROFILE=1
+                        --series writes throughput, memory usage, queue
+                                 length and load time every throughput
+                                 interval to a file, binary if its name
+                                 ends in .bin and CSV otherwise
+                        --percentiles adds the p50, p90, p99 and p99.9
+                                      turnaround, overhead and waiting
+                                      time to the summary
+                        --checkpoint saves a snapshot of the simulation to a
+                                     file once the clock reaches
+                                     --checkpoint-at, and carries on
+                        --restore starts from a snapshot instead of clock 0,
+                                  with the same trace, -m, -s, --buddy and
+                                  --percentiles but any single core policy.
+                                  Neither works with -c or --stream
+                        --sweep runs every combination of comma separated
+                                -a/-m/-s/-q/-c lists, -j threads at a time
+                        --limit clock time after which a sweep run is given
+                                up and reported as timed out, 0 never
+                                does. Defaults to SWEEP_SLOWDOWN times the
+                                trace's total job time after its last
+                                arrival  */
 
-    while ((opt = getopt(argc, argv, "f:a:m:s:q::")) != -1) {
+    while ((opt = getopt_long(argc, argv, "f:a:m:s:q::j:c:", long_options, NULL)) != -1) {
         if (opt == 'f') {
             filename = optarg;
         }
@@ -26,6 +91,7 @@ int main(int argc, char **argv)
             }
         }
         if ( opt == 's') {
+            mem_sizes = optarg;
             if (optarg == NULL) {
                 // Default value
                 optionals[MEM_INDX] = 0;
@@ -34,6 +100,7 @@ int main(int argc, char **argv)
             }
         }
         if ( opt == 'q') {
+            quanta = optarg;
             if (optarg == NULL) {
                 // Default value
                 optionals[QTM_INDX] = 10;
@@ -41,34 +108,202 @@ int main(int argc, char **argv)
                 optionals[QTM_INDX] = atoi(optarg);
             }
         }
+        if (opt == 'c') {
+            cores = optarg;
+            optionals[CORES_INDX] = atoi(optarg);
+        }
+        if (opt == 'j') {
+            threads = atoi(optarg);
+        }
+        if (opt == QUIET_OPT) {
+            quiet = 1;
+        }
+        if (opt == SWEEP_OPT) {
+            sweeping = 1;
+        }
+        if (opt == STREAM_OPT) {
+            streaming = 1;
+        }
+        if (opt == LEVELS_OPT) {
+            optionals[LEVELS_INDX] = atoi(optarg);
+            levels_given = 1;
+        }
+        if (opt == QUANTA_OPT) {
+            num_quanta = 0;
+            for (level_quantum = strtok(optarg, ","); level_quantum != NULL;
+                 level_quantum = strtok(NULL, ",")) {
+                if ((num_quanta == MAX_LEVELS) || (atoi(level_quantum) < 1)) {
+                    fprintf(stderr, "Wrong Command Line Arguments");
+                    exit(1);
+                }
+                optionals[LEVEL_QTM_INDX + num_quanta++] = atoi(level_quantum);
+            }
+        }
+        if (opt == BOOST_OPT) {
+            optionals[BOOST_INDX] = atoi(optarg);
+        }
+        if (opt == BUDDY_OPT) {
+            optionals[BUDDY_INDX] = 1;
+        }
+        if (opt == PROFILE_OPT) {
+            profiling = 1;
+        }
+        if (opt == SERIES_OPT) {
+            series_file = optarg;
+        }
+        if (opt == PERCENTILES_OPT) {
+            optionals[PCTL_INDX] = 1;
+        }
+        if (opt == CHECKPOINT_OPT) {
+            checkpoint.save_file = optarg;
+        }
+        if (opt == CHECKPOINT_AT_OPT) {
+            checkpoint.save_at = atoi(optarg);
+        }
+        if (opt == RESTORE_OPT) {
+            checkpoint.restore_file = optarg;
+        }
+        if (opt == LIMIT_OPT) {
+            limit = atoi(optarg);
+        }
+        if (opt == LOG_THREADS_OPT) {
+            log_threads = atoi(optarg);
+        }
+        if (opt == READ_AHEAD_OPT) {
+            streaming = 1;
+            reading_ahead = 1;
+        }
         if ( opt == '?') {
             fprintf(stderr, "Wrong Command Line Arguments");
             exit(1);
         }
     }
 
-    strategy(filename, sched_alg, mem_alloc, optionals);
+    if ((num_quanta > 0) && (!levels_given)) {
+        optionals[LEVELS_INDX] = num_quanta;
+    }
+
+    // Buffered output must still go out if a run ends through exit()
+    atexit(flush_output);
+
+    if (sweeping) {
+        // Sweep runs load the trace once and have no event log
+        if ((filename == NULL) || (streaming) || (log_threads > 0)) {
+            fprintf(stderr, "Wrong Command Line Arguments");
+            exit(1);
+        }
+        sweep(filename, sched_alg, mem_alloc, mem_sizes, quanta, cores, threads, limit);
+        return 0;
+    }
+    // A single run always goes on to the end, and -j only sizes the sweep pool
+    if ((limit >= 0) || (threads > 0)) {
+        fprintf(stderr, "Wrong Command Line Arguments");
+        exit(1);
+    }
+
+    if ((filename == NULL) || (sched_alg == NULL) || (mem_alloc == NULL) ||
+        (optionals[CORES_INDX] < 1)) {
+        fprintf(stderr, "Wrong Command Line Arguments");
+        exit(1);
+    }
+    // Level queues and preemption on arrival are only simulated on one core
+    if (((!strcmp(sched_alg, "mlfq")) || (!strcmp(sched_alg, "srtf"))) &&
+        (optionals[CORES_INDX] > 1)) {
+        fprintf(stderr, "Wrong Command Line Arguments");
+        exit(1);
+    }
+    if ((!strcmp(sched_alg, "mlfq")) &&
+        ((optionals[LEVELS_INDX] < 1) || (optionals[LEVELS_INDX] > MAX_LEVELS) ||
+         (optionals[QTM_INDX] < 1) || (optionals[BOOST_INDX] < 0))) {
+        fprintf(stderr, "Wrong Command Line Arguments");
+        exit(1);
+    }
+    // Snapshots cover the single core loops over a fully loaded trace
+    if (((checkpoint.save_file != NULL) || (checkpoint.restore_file != NULL)) &&
+        ((optionals[CORES_INDX] > 1) || (streaming))) {
+        fprintf(stderr, "Wrong Command Line Arguments");
+        exit(1);
+    }
+    checkpoint.sched_alg = sched_alg;
+    checkpoint.mem_alloc = mem_alloc;
+    strategy(filename, sched_alg, mem_alloc, optionals, log_threads, streaming, reading_ahead,
+             profiling, series_file, &checkpoint);
 
     return 0;
 }
 
-/* Calls scheduling/memory allocation algorithms and sets variables
-   according to the specified options */
+/* Reads the processes from file, simulates them according to the specified
+   options and prints the performance summary */
 
-void strategy(char *filename, char *sched_alg, char *mem_alloc, int *optionals)
+void strategy(char *filename, char *sched_alg, char *mem_alloc, int *optionals, int log_threads,
+              int streaming, int reading_ahead, int profiling, char *series_file,
+              Checkpoint *checkpoint)
 {
-    Deque *process_list;
+    Trace *process_list;
+    Arena *arena;
     Statistics *stats;
-    int completion_time;
-    Memory* memory;
-    int (*mem_strat)(int, Memory*, Deque*, Process*);
+    Series *series = NULL;
 
-    // First read input from file
-    process_list = read_processes(filename);
-    // Pre-emptive sorting confirmed to be allowed, do it here
-    order_deque(process_list);
+    // First read input from file, every process lives in the arena until the end
+    arena = new_arena();
+    // Pre-emptive sorting confirmed to be allowed, load_trace() does it
+    if (streaming) {
+        // Only processes yet to finish are held, finished ones are reused
+        process_list = stream_trace(filename, arena);
+        if (reading_ahead) {
+            read_ahead(process_list);
+        }
+    } else {
+        process_list = load_trace(filename, arena);
+    }
     //testing(process_list);
-    stats = init_stats();
+
+    // The simulation itself stays serial, other threads read its arrivals and render its log
+    if ((log_threads > 1) && (!quiet)) {
+        start_events(log_threads);
+    }
+    if (series_file != NULL) {
+        series = open_series(series_file, INTRVL_RANGE);
+    }
+    stats = simulate(process_list, sched_alg, mem_alloc, optionals, series, checkpoint);
+    finish_events();
+    if (series != NULL) {
+        close_series(series);
+    }
+
+    // All processes finished, summarise performace
+    print_performance(stats);
+    if (profiling) {
+        print_profile();
+    }
+    free_trace(process_list);
+    free_arena(arena);
+    free_stats(stats);
+    return;
+}
+
+/* Calls scheduling/memory allocation algorithms and sets variables according
+   to the specified options, then returns the finalised statistics. Only state
+   created here, series and checkpoint, which may be NULL, is modified, so
+   simulations of the same trace can run side by side */
+
+Statistics *simulate(Trace *process_list, char *sched_alg, char *mem_alloc, int *optionals,
+                     Series *series, Checkpoint *checkpoint)
+{
+    Statistics *stats;
+    int completion_time=0;
+    int level;
+    int quanta[MAX_LEVELS];
+    Memory* memory;
+    int (*mem_strat)(int, Memory*, long, Process*);
+
+    PROFILE_START(PHASE_SCHEDULING);
+    stats = init_stats(optionals[CORES_INDX]);
+    stats->series = series;
+    stats->time_limit = optionals[LIMIT_INDX];
+    if (optionals[PCTL_INDX]) {
+        track_percentiles(stats);
+    }
 
     /* MEMORY MANAGEMENT ALGORITHMS */
     memory = init_memory(optionals[MEM_INDX]);
@@ -80,71 +315,76 @@ void strategy(char *filename, char *sched_alg, char *mem_alloc, int *optionals)
         mem_strat = swapping;
     } else if (!strcmp(mem_alloc, "v")) {
         mem_strat = virtual;
+    } else if (!strcmp(mem_alloc, "clock")) {
+        track_references(memory);
+        stats->reports_loads = 1;
+        mem_strat = clock_replace;
     } else {
         mem_strat = fair;
     }
+    if ((optionals[BUDDY_INDX]) && (mem_strat != NULL)) {
+        use_buddy(memory);
+        stats->reports_fragmentation = 1;
+    }
 
     /* SCHEDULING ALGORITHMS */
-    // First come, first served
-    if (!strcmp(sched_alg, "ff")) {
-        completion_time = fcfs(process_list, stats, memory, mem_strat);
-    }
-    //Round Robin
-    if (!strcmp(sched_alg, "rr")) {
+    // Several cores share one simulation of the chosen policy
+    if (optionals[CORES_INDX] > 1) {
+        completion_time = multicore(process_list, sched_alg, optionals[QTM_INDX],
+                                    optionals[CORES_INDX], stats, memory, mem_strat);
+    } else if (!strcmp(sched_alg, "ff")) { // First come, first served
+        completion_time = fcfs(process_list, stats, memory, mem_strat, checkpoint);
+    } else if (!strcmp(sched_alg, "rr")) { // Round Robin
         completion_time = round_robin(process_list, optionals[QTM_INDX],
-                                      stats, memory, mem_strat);
-    }
-    // Shortest First
-    if (!strcmp(sched_alg, "cs")) {
-        completion_time = shortest_first(process_list, stats, memory, mem_strat);
+                                      stats, memory, mem_strat, checkpoint);
+    } else if (!strcmp(sched_alg, "cs")) { // Shortest First
+        completion_time = shortest_first(process_list, stats, memory, mem_strat, checkpoint);
+    } else if (!strcmp(sched_alg, "srtf")) { // Shortest remaining time first
+        completion_time = srtf(process_list, stats, memory, mem_strat, checkpoint);
+    } else if (!strcmp(sched_alg, "mlfq")) { // Multi-level feedback queue
+        // Levels without a quantum of their own double the last
+        for (level=0; level<optionals[LEVELS_INDX]; level++) {
+            quanta[level] = optionals[LEVEL_QTM_INDX + level];
+            if (quanta[level] == 0) {
+                quanta[level] = (level == 0) ? optionals[QTM_INDX] : 2*quanta[level-1];
+            }
+        }
+        track_levels(stats, optionals[LEVELS_INDX]);
+        completion_time = mlfq(process_list, optionals[LEVELS_INDX], quanta,
+                               optionals[BOOST_INDX], stats, memory, mem_strat, checkpoint);
     }
 
-    // All processes finished, summarise performace
-    finalise_stats(completion_time, stats);
-    print_performance(stats);
-    free_deque(process_list);
-    free_memory(memory);
-    free(stats);
-    return;
-}
-
-/* Reads all processes from file */
-Deque *read_processes(char *filename)
-{
-    Deque *process_list = new_deque();
-    Process *created;
-    char process_line[LINE_BUFF];
-    FILE *input = fopen(filename, "r");
-
-    while (fgets(process_line, sizeof(process_line), input) != NULL) {
-        created = new_process(process_line);
-        deque_append(process_list, created);
+    stats->pages_loaded = memory->pages_loaded;
+    if (memory->frag_samples > 0) {
+        stats->largest_free[LF_MIN] = memory->largest_free_min;
+        stats->largest_free[LF_AVG] = (float)memory->largest_free_total / memory->frag_samples;
+        stats->fragmentation[FRAG_MAX] = memory->frag_max;
+        stats->fragmentation[FRAG_AVG] = memory->frag_total / memory->frag_samples;
     }
-    fclose(input);
-
-    return process_list;
+    // A run that gave up has nothing to average
+    if (!stats->timed_out) {
+        finalise_stats(completion_time, stats);
+    }
+    free_memory(memory);
+    PROFILE_STOP();
+    return stats;
 }
 
-void testing(Deque *process_list)
+void testing(Trace *process_list)
 {
-    Process *prints;
-    Node *next_node;
+    int i;
 
-    next_node = process_list->head;
-    prints = next_node->process;
-    while (next_node != NULL) {
-        prints = next_node->process;
+    for (i=process_list->next; i<process_list->count; i++) {
         printf("FOUR TUPLE\n");
-        printf("%d, %d, %d, %d", prints->arrival_time, prints->pid, prints->mem_req, prints->job_time);
+        printf("%d, %d, %d, %d", process_list->columns[ARRIVED][i], process_list->columns[ID][i],
+               process_list->columns[MEM_REQ][i]/KB_PER_PAGE, process_list->columns[JOB_TIME][i]);
         printf("\n");
-        next_node = next_node->next;
-
     }
 }
 
 /* First come, first served */
-int fcfs(Deque *process_list, Statistics *stats, Memory *memory,
-         int (*mem_strat)(int, Memory*, Deque*, Process*))
+int fcfs(Trace *process_list, Statistics *stats, Memory *memory,
+         int (*mem_strat)(int, Memory*, long, Process*), Checkpoint *checkpoint)
 {
     int clock = 0;
     int load_time = 0;
@@ -153,17 +393,26 @@ int fcfs(Deque *process_list, Statistics *stats, Memory *memory,
     Deque *arrived = new_deque();
     Process *curr;
 
-
-    while ((!deque_null(process_list)) || (!deque_null(arrived))) {
+    // Carry on from a snapshot instead of clock 0
+    if (checkpoint_restoring(checkpoint)) {
+        clock = restore_checkpoint(checkpoint, process_list, &arrived, 1, NULL, NULL,
+                                   memory, stats);
+    }
+    while (((!trace_done(process_list)) || (!deque_null(arrived))) &&
+           (!out_of_time(stats, clock))) {
+        if (checkpoint_due(checkpoint, clock)) {
+            save_checkpoint(checkpoint, clock, process_list, &arrived, 1, NULL, 0, memory, stats);
+        }
         update_deque(clock, process_list, arrived);
         if (!deque_null(arrived)) {
             curr = deque_pop(arrived);
             // First, load job
             if (mem_strat != NULL) {
-                load_time = (*mem_strat)(clock, memory, arrived, curr);
+                load_time = (*mem_strat)(clock, memory, deque_total_remaining(arrived), curr);
             }
             // Start job
-            print_execution(clock, curr, load_time, memory->mem_usage);
+            print_execution(clock, curr, load_time, memory->mem_usage, NO_CORE);
+            update_dispatch_stats(clock, stats, load_time, memory->mem_usage, arrived->size);
             clock = step(clock, curr->job_time+load_time, process_list, arrived);
             // Evict then finish
             if (mem_strat != NULL) {
@@ -173,10 +422,10 @@ int fcfs(Deque *process_list, Statistics *stats, Memory *memory,
                 free(evicted_pages);
             }
             update_stats(clock, stats, curr);
-            print_finishing(clock, curr->pid, arrived->size);
-            free(curr);
-        } else { // Wait for new arrivals
-            clock++;
+            print_finishing(clock, curr->pid, arrived->size, NO_CORE);
+            release_process(process_list, curr);
+        } else { // Idle, jump straight to the next arrival
+            clock = next_arrival(process_list);
         }
     }
 
@@ -184,8 +433,8 @@ int fcfs(Deque *process_list, Statistics *stats, Memory *memory,
     return clock;
 }
 
-int round_robin(Deque *process_list, int quantum, Statistics *stats, Memory *memory,
-                int (*mem_strat)(int, Memory*, Deque*, Process*))
+int round_robin(Trace *process_list, int quantum, Statistics *stats, Memory *memory,
+                int (*mem_strat)(int, Memory*, long, Process*), Checkpoint *checkpoint)
 {
     int clock = 0;
     int load_time = 0;
@@ -194,17 +443,27 @@ int round_robin(Deque *process_list, int quantum, Statistics *stats, Memory *mem
     Deque *arrived = new_deque();
     Process *curr;
 
-    while ((!deque_null(process_list)) || (!deque_null(arrived))) {
+    // Carry on from a snapshot instead of clock 0
+    if (checkpoint_restoring(checkpoint)) {
+        clock = restore_checkpoint(checkpoint, process_list, &arrived, 1, NULL, NULL,
+                                   memory, stats);
+    }
+    while (((!trace_done(process_list)) || (!deque_null(arrived))) &&
+           (!out_of_time(stats, clock))) {
+        if (checkpoint_due(checkpoint, clock)) {
+            save_checkpoint(checkpoint, clock, process_list, &arrived, 1, NULL, 0, memory, stats);
+        }
         update_deque(clock, process_list, arrived);
         //testing(arrived);
         if (!deque_null(arrived)) {
             curr = deque_pop(arrived);
             // Load job
             if (mem_strat != NULL) {
-                load_time = (*mem_strat)(clock, memory, arrived, curr);
+                load_time = (*mem_strat)(clock, memory, deque_total_remaining(arrived), curr);
             }
             // Start current job
-            print_execution(clock, curr, load_time, memory->mem_usage);
+            print_execution(clock, curr, load_time, memory->mem_usage, NO_CORE);
+            update_dispatch_stats(clock, stats, load_time, memory->mem_usage, arrived->size);
             // Finish job within quantum
             if (curr->remaining_time <= quantum) {
                 clock = step(clock, curr->remaining_time+load_time, process_list, arrived);
@@ -215,42 +474,191 @@ int round_robin(Deque *process_list, int quantum, Statistics *stats, Memory *mem
                     free(evicted_pages);
                 }
                 update_stats(clock, stats, curr);
-                print_finishing(clock, curr->pid, arrived->size);
-                free_process(curr);
+                print_finishing(clock, curr->pid, arrived->size, NO_CORE);
+                release_process(process_list, curr);
             } else { // Quantum elapsed, process goes to the back
                 clock = step(clock, quantum+load_time, process_list, arrived);
                 curr->remaining_time -= quantum;
+                reference_pages(memory, curr, quantum);
                 deque_append(arrived, curr);
             }
-        } else { // Wait for new arrivals
-            clock++;
+        } else { // Idle, jump straight to the next arrival
+            clock = next_arrival(process_list);
         }
     }
     free_deque(arrived);
     return clock;
 }
 
-int shortest_first(Deque *process_list, Statistics *stats, Memory *memory,
-                   int (*mem_strat)(int, Memory*, Deque*, Process*))
+/* Multi-level feedback queue. Arrivals join the top level, a process that
+   uses up its level's quantum drops a level, and every boost time units all
+   processes go back to the top. The lowest set bit of nonempty is the level
+   to run next. Memory strategies see the time remaining over every level */
+int mlfq(Trace *process_list, int num_levels, int *quanta, int boost, Statistics *stats,
+         Memory *memory, int (*mem_strat)(int, Memory*, long, Process*),
+         Checkpoint *checkpoint)
 {
     int clock = 0;
     int load_time = 0;
+    int level;
+    long next_boost = boost;
+    int queued = 0; // Processes waiting over every level
     int num_evicted;
     int *evicted_pages;
+    unsigned int nonempty = 0;
     Deque *arrived = new_deque();
+    Deque *levels[MAX_LEVELS + 1]; // Snapshots take arrived as the level after the last
     Process *curr;
 
-    while ((!deque_null(process_list)) || (!deque_null(arrived))) {
+    for (level=0; level<num_levels; level++) {
+        levels[level] = new_deque();
+    }
+    levels[num_levels] = arrived;
+    // Carry on from a snapshot instead of clock 0
+    if (checkpoint_restoring(checkpoint)) {
+        clock = restore_checkpoint(checkpoint, process_list, levels, num_levels + 1, NULL,
+                                   &next_boost, memory, stats);
+        for (level=0; level<num_levels; level++) {
+            if (!deque_null(levels[level])) {
+                nonempty |= 1u << level;
+                queued += deque_size(levels[level]);
+            }
+        }
+    }
+
+    while (((!trace_done(process_list)) || (nonempty != 0)) && (!out_of_time(stats, clock))) {
+        if (checkpoint_due(checkpoint, clock)) {
+            save_checkpoint(checkpoint, clock, process_list, levels, num_levels + 1, NULL,
+                            next_boost, memory, stats);
+        }
         update_deque(clock, process_list, arrived);
-        prioritise(arrived);
+        if ((boost > 0) && (clock >= next_boost)) {
+            boost_levels(levels, num_levels, &nonempty);
+            next_boost = clock - clock % boost + boost;
+        }
+        // Arrivals join the top level before a preempted process drops
+        while (!deque_null(arrived)) {
+            deque_append(levels[0], deque_pop(arrived));
+            nonempty |= 1;
+            queued++;
+        }
+        if (nonempty != 0) {
+            level = ffs(nonempty) - 1;
+            curr = deque_pop(levels[level]);
+            queued--;
+            if (deque_null(levels[level])) {
+                nonempty &= ~(1u << level);
+            }
+            // Load job
+            if (mem_strat != NULL) {
+                load_time = (*mem_strat)(clock, memory, levels_remaining(levels, num_levels),
+                                         curr);
+            }
+            // Start current job
+            print_execution(clock, curr, load_time, memory->mem_usage, NO_CORE);
+            update_dispatch_stats(clock, stats, load_time, memory->mem_usage,
+                                  queued + arrived->size);
+            // Finish job within the level's quantum
+            if (curr->remaining_time <= quanta[level]) {
+                clock = step(clock, curr->remaining_time+load_time, process_list, arrived);
+                if (mem_strat != NULL) {
+                    num_evicted = curr->pages_used;
+                    evicted_pages = evict_memory(memory, curr, num_evicted);
+                    print_evicted(clock, evicted_pages, num_evicted);
+                    free(evicted_pages);
+                }
+                update_stats(clock, stats, curr);
+                update_level_stats(clock, stats, curr, level);
+                print_finishing(clock, curr->pid, queued + arrived->size, NO_CORE);
+                release_process(process_list, curr);
+            } else { // Quantum elapsed, process drops a level
+                clock = step(clock, quanta[level]+load_time, process_list, arrived);
+                curr->remaining_time -= quanta[level];
+                reference_pages(memory, curr, quanta[level]);
+                while (!deque_null(arrived)) {
+                    deque_append(levels[0], deque_pop(arrived));
+                    nonempty |= 1;
+                    queued++;
+                }
+                if (level < num_levels - 1) {
+                    level++;
+                }
+                deque_append(levels[level], curr);
+                nonempty |= 1u << level;
+                queued++;
+            }
+        } else { // Idle, jump straight to the next arrival
+            clock = next_arrival(process_list);
+        }
+    }
+
+    for (level=0; level<num_levels; level++) {
+        free_deque(levels[level]);
+    }
+    free_deque(arrived);
+    return clock;
+}
+
+// Moves every process below the top level of mlfq to the back of the top level
+void boost_levels(Deque **levels, int num_levels, unsigned int *nonempty)
+{
+    int level;
+
+    PROFILE_START(PHASE_QUEUE);
+    for (level=1; level<num_levels; level++) {
+        while (!deque_null(levels[level])) {
+            deque_append(levels[0], deque_pop(levels[level]));
+        }
+    }
+    *nonempty = deque_null(levels[0]) ? 0 : 1;
+    PROFILE_STOP();
+}
+
+// Returns the total remaining time of the processes waiting over every level of mlfq
+long levels_remaining(Deque **levels, int num_levels)
+{
+    int level;
+    long total = 0;
+
+    for (level=0; level<num_levels; level++) {
+        total += deque_total_remaining(levels[level]);
+    }
+    return total;
+}
+
+int shortest_first(Trace *process_list, Statistics *stats, Memory *memory,
+                   int (*mem_strat)(int, Memory*, long, Process*), Checkpoint *checkpoint)
+{
+    int clock = 0;
+    int load_time = 0;
+    int num_evicted;
+    int *evicted_pages;
+    Deque *arrived = new_deque();
+    // Keeps arrived in heap order by job time
+    Heap *ready = new_heap(arrived);
+    Process *curr;
+
+    // Carry on from a snapshot instead of clock 0
+    if (checkpoint_restoring(checkpoint)) {
+        clock = restore_checkpoint(checkpoint, process_list, &arrived, 1, ready, NULL,
+                                   memory, stats);
+    }
+    while (((!trace_done(process_list)) || (!deque_null(arrived))) &&
+           (!out_of_time(stats, clock))) {
+        if (checkpoint_due(checkpoint, clock)) {
+            save_checkpoint(checkpoint, clock, process_list, &arrived, 1, ready, 0, memory, stats);
+        }
+        update_deque(clock, process_list, arrived);
+        heap_fill(ready);
         if (!deque_null(arrived)) {
-            curr = deque_pop(arrived);
+            curr = heap_pop(ready);
             // Load job
             if (mem_strat != NULL) {
-                load_time = (*mem_strat)(clock, memory, arrived, curr);
+                load_time = (*mem_strat)(clock, memory, deque_total_remaining(arrived), curr);
             }
             // Start current job
-            print_execution(clock, curr, load_time, memory->mem_usage);
+            print_execution(clock, curr, load_time, memory->mem_usage, NO_CORE);
+            update_dispatch_stats(clock, stats, load_time, memory->mem_usage, arrived->size);
             clock = step(clock, curr->job_time+load_time, process_list, arrived);
             // Evict then finish
             if (mem_strat != NULL) {
@@ -260,70 +668,243 @@ int shortest_first(Deque *process_list, Statistics *stats, Memory *memory,
                 free(evicted_pages);
             }
             update_stats(clock, stats, curr);
-            print_finishing(clock, curr->pid, arrived->size);
-            free(curr);
-        } else {
-            clock++;
+            print_finishing(clock, curr->pid, arrived->size, NO_CORE);
+            release_process(process_list, curr);
+        } else { // Idle, jump straight to the next arrival
+            clock = next_arrival(process_list);
         }
     }
+    free_heap(ready);
+    free_deque(arrived);
     return clock;
 }
 
-void print_execution(int clock, Process* process, int load_time, int mem_usage)
+/* Shortest remaining time first. A running process is preempted as soon
+   as a process with strictly less time remaining arrives, or once its load
+   finishes if the arrival came while it was loading */
+int srtf(Trace *process_list, Statistics *stats, Memory *memory,
+         int (*mem_strat)(int, Memory*, long, Process*), Checkpoint *checkpoint)
 {
-    int i=0;
-    if (mem_usage >= 0) {
-        printf("%d, RUNNING, id=%d, remaining-time=%d, load-time=%d, mem-usage=%d\%, ",
-                clock, process->pid, process->remaining_time, load_time, mem_usage);
-        printf("mem-addresses=[");
-        while (i < process->pages_used) {
-            if (i == process->pages_used - 1) {
-                printf("%d]\n", process->mem_index[i]);
-            } else {
-                printf("%d,", process->mem_index[i]);
+    int clock = 0;
+    int load_time = 0;
+    int start, finish;
+    int preempted;
+    int num_evicted;
+    int *evicted_pages;
+    Deque *arrived = new_deque();
+    // Keeps arrived in heap order by remaining time
+    Heap *ready = new_remaining_heap(arrived);
+    Process *curr;
+
+    // Carry on from a snapshot instead of clock 0
+    if (checkpoint_restoring(checkpoint)) {
+        clock = restore_checkpoint(checkpoint, process_list, &arrived, 1, ready, NULL,
+                                   memory, stats);
+    }
+    while (((!trace_done(process_list)) || (!deque_null(arrived))) &&
+           (!out_of_time(stats, clock))) {
+        if (checkpoint_due(checkpoint, clock)) {
+            save_checkpoint(checkpoint, clock, process_list, &arrived, 1, ready, 0, memory, stats);
+        }
+        update_deque(clock, process_list, arrived);
+        heap_fill(ready);
+        if (!deque_null(arrived)) {
+            curr = heap_pop(ready);
+            // Load job
+            if (mem_strat != NULL) {
+                load_time = (*mem_strat)(clock, memory, deque_total_remaining(arrived), curr);
+            }
+            // Start current job
+            print_execution(clock, curr, load_time, memory->mem_usage, NO_CORE);
+            update_dispatch_stats(clock, stats, load_time, memory->mem_usage, arrived->size);
+            start = clock + load_time;
+            finish = start + curr->remaining_time;
+
+            // Run until finished, checking each arrival before then for a shorter job
+            preempted = 0;
+            while ((!trace_done(process_list)) && (next_arrival(process_list) < finish)) {
+                clock = (next_arrival(process_list) > start) ? next_arrival(process_list) : start;
+                update_deque(clock, process_list, arrived);
+                heap_fill(ready);
+                if (heap_peek(ready)->remaining_time < finish - clock) {
+                    preempted = 1;
+                    break;
+                }
             }
-            i++;
+            if (preempted) {
+                if (clock > start) {
+                    reference_pages(memory, curr, clock - start);
+                }
+                curr->remaining_time = finish - clock;
+                deque_append(arrived, curr);
+                heap_fill(ready);
+                continue;
+            }
+            clock = step(clock, finish - clock, process_list, arrived);
+            // Evict then finish
+            if (mem_strat != NULL) {
+                num_evicted = curr->pages_used;
+                evicted_pages = evict_memory(memory, curr, num_evicted);
+                print_evicted(clock, evicted_pages, num_evicted);
+                free(evicted_pages);
+            }
+            update_stats(clock, stats, curr);
+            print_finishing(clock, curr->pid, arrived->size, NO_CORE);
+            release_process(process_list, curr);
+        } else { // Idle, jump straight to the next arrival
+            clock = next_arrival(process_list);
         }
-    } else {
-        printf("%d, RUNNING, id=%d, remaining-time=%d\n",
-                clock, process->pid, process->remaining_time);
     }
+    free_heap(ready);
+    free_deque(arrived);
+    return clock;
+}
 
+void print_execution(int clock, Process* process, int load_time, int mem_usage, int core)
+{
+    // Every process put on a core is a context switch, logged or not
+    PROFILE_COUNT(PROF_SWITCHES, 1);
+    if (quiet) {
+        return;
+    }
+    PROFILE_START(PHASE_OUTPUT);
+    log_running(clock, process->pid, process->remaining_time, load_time, mem_usage,
+                core, process->mem_index + process->mem_start, process->pages_used);
+    PROFILE_STOP();
 }
 
-void print_finishing(int clock, int pid, int proc_remaining)
+void print_finishing(int clock, int pid, int proc_remaining, int core)
 {
-    printf("%d, FINISHED, id=%d, proc-remaining=%d\n", clock, pid, proc_remaining);
+    if (quiet) {
+        return;
+    }
+    PROFILE_START(PHASE_OUTPUT);
+    log_finished(clock, pid, proc_remaining, core);
+    PROFILE_STOP();
 }
 
 void print_performance(Statistics *stats)
 {
-    printf("Throughput %d, %d, %d\n",
-            stats->throughput[TH_AVG], stats->throughput[TH_MIN],
-            stats->throughput[TH_MAX]);
-           printf("Turnaround time %d\n", stats->turnaround);
-           printf("Time overhead %.2f %.2f\n",
-                   stats->overhead[OVR_MAX], stats->overhead[OVR_AVG]);
-           printf("Makespan %d\n", stats->makespan);
+    int i;
+    char line[LINE_BUFF];
+
+    output_str("Throughput ");
+    output_int(stats->throughput[TH_AVG]);
+    output_str(", ");
+    output_int(stats->throughput[TH_MIN]);
+    output_str(", ");
+    output_int(stats->throughput[TH_MAX]);
+    output_str("\nTurnaround time ");
+    output_int(stats->turnaround);
+    snprintf(line, sizeof(line), "\nTime overhead %.2f %.2f\n",
+             stats->overhead[OVR_MAX], stats->overhead[OVR_AVG]);
+    output_str(line);
+    output_str("Makespan ");
+    output_int(stats->makespan);
+    output_char('\n');
+    if (stats->reports_loads) {
+        output_str("Pages loaded ");
+        output_int(stats->pages_loaded);
+        output_char('\n');
+    }
+    // Largest free block in pages, fragmentation as the percentage of empty pages outside it
+    if (stats->reports_fragmentation) {
+        snprintf(line, sizeof(line), "Largest free block %.0f %.2f\n",
+                 stats->largest_free[LF_MIN], stats->largest_free[LF_AVG]);
+        output_str(line);
+        snprintf(line, sizeof(line), "External fragmentation %.2f%% %.2f%%\n",
+                 stats->fragmentation[FRAG_MAX], stats->fragmentation[FRAG_AVG]);
+        output_str(line);
+    }
+    // A single core is fully described by the lines above
+    if (stats->num_cores > 1) {
+        for (i=0; i<stats->num_cores; i++) {
+            output_str("Core ");
+            output_int(i);
+            output_str(" utilisation ");
+            output_int(core_utilisation(stats, i));
+            output_str("%\n");
+        }
+    }
+    // Only mlfq has levels
+    for (i=0; i<stats->num_levels; i++) {
+        output_str("Level ");
+        output_int(i);
+        output_str(" turnaround ");
+        output_int(level_turnaround(stats, i));
+        output_str(", ");
+        output_int(stats->level_finished[i]);
+        output_str(" finished\n");
+    }
+    // Tail latencies, only kept when asked for
+    if (stats->histograms[HIST_TURNAROUND] != NULL) {
+        print_percentiles("Turnaround time", stats->histograms[HIST_TURNAROUND], 0);
+        print_percentiles("Time overhead", stats->histograms[HIST_OVERHEAD], 1);
+        print_percentiles("Waiting time", stats->histograms[HIST_WAITING], 0);
+    }
 }
 
-void print_evicted(int clock, int *evicted_pages, int num_evicted)
+// Prints percentiles of a histogram on one line, values kept in hundredths with two decimals
+void print_percentiles(char *name, Histogram *histogram, int hundredths)
 {
-    int i=0;
-    qsort(evicted_pages, num_evicted, sizeof(int), page_comp);
-    printf("%d, EVICTED, mem-addresses=[", clock);
-    while (i < num_evicted) {
-        if (i == num_evicted - 1) {
-            printf("%d]\n", evicted_pages[i]);
+    int i;
+    long value;
+    char line[LINE_BUFF];
+    const double percentiles[NUM_PERCENTILES] = {50, 90, 99, 99.9};
+
+    output_str(name);
+    for (i=0; i<NUM_PERCENTILES; i++) {
+        value = histogram_percentile(histogram, percentiles[i]);
+        if (hundredths) {
+            snprintf(line, sizeof(line), " p%g %.2f", percentiles[i], value / 100.0);
         } else {
-            printf("%d,", evicted_pages[i]);
+            snprintf(line, sizeof(line), " p%g %ld", percentiles[i], value);
         }
-        i++;
+        output_str(line);
+        output_char((i < NUM_PERCENTILES - 1) ? ',' : '\n');
     }
 }
 
+// Prints the instrumentation counters and the time spent in each phase of the simulation
+void print_profile()
+{
+#ifdef PROFILE
+    int i;
+    char line[LINE_BUFF];
+    const char *counter_names[NUM_COUNTERS] = {
+        "page faults", "evictions", "deque visits", "context switches"
+    };
+    const char *phase_names[NUM_PHASES] = {"scheduling", "queue", "memory", "output"};
+
+    for (i=0; i<NUM_COUNTERS; i++) {
+        output_str("Profile ");
+        output_str(counter_names[i]);
+        output_char(' ');
+        output_int(profile.counters[i]);
+        output_char('\n');
+    }
+    for (i=0; i<NUM_PHASES; i++) {
+        snprintf(line, sizeof(line), "Profile %s %.3f ms\n", phase_names[i],
+                 profile.phase_ns[i] / 1e6);
+        output_str(line);
+    }
+#else
+    fprintf(stderr, "Profiling isn't built in, rebuild with make clean && make PROFILE=1\n");
+#endif
+}
+
+void print_evicted(int clock, int *evicted_pages, int num_evicted)
+{
+    if (quiet) {
+        return;
+    }
+    PROFILE_START(PHASE_OUTPUT);
+    log_evicted(clock, evicted_pages, num_evicted);
+    PROFILE_STOP();
+}
+
 // Updates clock, stats and structure of process_list/arrived as appropriate
-int step(int clock, int step, Deque *process_list, Deque *arrived)
+int step(int clock, int step, Trace *process_list, Deque *arrived)
 {
     int curr_time=clock+step;
     update_deque(curr_time, process_list, arrived);
@@ -331,53 +912,58 @@ int step(int clock, int step, Deque *process_list, Deque *arrived)
 }
 
 // Handles memory management using Swapping-X and returns load time
-int swapping(int clock, Memory *memory, Deque* arrived, Process *process)
+int swapping(int clock, Memory *memory, long waiting_time, Process *process)
 {
     int load_time, index=0;
     int num_evicted = 0;
-    int *evicted_pages = (int*)malloc((memory->total_pages)*sizeof(int));
+    int *evicted_pages;
     int *curr_evicted;
-    Node *least_recent = get_least_recent(arrived);
-
+    Process *victim;
 
+    // The running process is never a victim, and is the most recent once loaded
+    unlink_resident(memory, process);
     if (process->pages_used == process->mem_req) {
+        append_resident(memory, process);
         return 0;
     }
+    evicted_pages = (int*)malloc((memory->total_pages)*sizeof(int));
     // No space? Evict memory from least recently executed process until there is
     while ((process->mem_req - process->pages_used) > memory->empty_pages) {
-        if (least_recent == NULL) {
+        victim = memory->least_recent;
+        if (victim == NULL) {
             fprintf(stderr, "Swapping least recent is null. May have gone past foot\n");
             break;
         }
-        if (least_recent->process->pages_used > 0) {
-            index += num_evicted;
-            num_evicted = least_recent->process->pages_used;
-            curr_evicted = evict_memory(memory, least_recent->process,
-                                        least_recent->process->pages_used);
-            memmove(evicted_pages+index, curr_evicted, num_evicted*sizeof(int));
-            free(curr_evicted);
-        }
-        least_recent = least_recent->next;
+        // Evicting every page also takes the victim off the resident list
+        index += num_evicted;
+        num_evicted = victim->pages_used;
+        curr_evicted = evict_memory(memory, victim, victim->pages_used);
+        memmove(evicted_pages+index, curr_evicted, num_evicted*sizeof(int));
+        free(curr_evicted);
     }
     if (num_evicted > 0) {
         print_evicted(clock, evicted_pages, num_evicted);
     }
     load_time = 2 * allocate_memory(memory, process,
                                     process->mem_req - process->pages_used);
+    append_resident(memory, process);
     free(evicted_pages);
     return load_time;
 }
 
 // Handles memory management using Virtual Memory and returns load time
-int virtual(int clock, Memory *memory, Deque *arrived, Process *process)
+int virtual(int clock, Memory *memory, long waiting_time, Process *process)
 {
     int load_time, min_pages;
     int num_evicted = 0;
-    int *evicted_pages = (int*)malloc((memory->total_pages)*sizeof(int));
+    int *evicted_pages;
     int *curr_evicted;
-    Node *least_recent = get_least_recent(arrived);
+    Process *victim;
 
+    // The running process is never a victim, and is the most recent once loaded
+    unlink_resident(memory, process);
     if (process->pages_used == process->mem_req) {
+        append_resident(memory, process);
         return 0;
     }
 
@@ -387,81 +973,110 @@ int virtual(int clock, Memory *memory, Deque *arrived, Process *process)
     // No need to evict, allocate as many as possible
     if (memory->empty_pages >= min_pages) {
         load_time = allocate_all(memory, process);
+        append_resident(memory, process);
         return load_time;
     }
 
     // Otherwise have to evict
+    evicted_pages = (int*)malloc((memory->total_pages)*sizeof(int));
     while (memory->empty_pages < min_pages) {
-        if (least_recent == NULL) {
+        victim = memory->least_recent;
+        if (victim == NULL) {
             fprintf(stderr, "Virtual least recent is null. May have gone past foot\n");
             break;
         }
-        while (least_recent->process->pages_used > 0) {
-            if (memory->empty_pages >= min_pages) {
-                break;
-            }
-            // Evict one by one
-            curr_evicted = evict_memory(memory, least_recent->process, 1);
-            evicted_pages[num_evicted] = *curr_evicted;
-            num_evicted += 1;
-            free(curr_evicted);
-        }
-        least_recent = least_recent->next;
+        // Evict one by one, the victim leaves the resident list with its last page
+        curr_evicted = evict_memory(memory, victim, 1);
+        evicted_pages[num_evicted] = *curr_evicted;
+        num_evicted += 1;
+        free(curr_evicted);
     }
     print_evicted(clock, evicted_pages, num_evicted);
+    free(evicted_pages);
     load_time = 2 * allocate_memory(memory, process, min_pages);
+    append_resident(memory, process);
     process->remaining_time += process->mem_req - process->pages_used;
     return load_time;
 }
 
-// Handles memory management by trying to evict equal pages from all arrived processes
-int fair(int clock, Memory *memory, Deque *arrived, Process *process)
+// Handles memory management like virtual(), but evicts single pages with the clock algorithm
+int clock_replace(int clock, Memory *memory, long waiting_time, Process *process)
 {
-    int num_evicted=0;
-    int old_evicted=0;
-    int force=0;
-    int load_time, min_pages, alloc_pages;
-    int *evicted_pages = (int*)malloc((memory->total_pages)*sizeof(int));
-    int *curr_evicted;
-    Node *curr = arrived->head;
-
+    int load_time, min_pages;
+    int num_evicted;
+    int *evicted_pages;
 
+    // The running process is never a victim, and is the most recent once loaded
+    unlink_resident(memory, process);
     if (process->pages_used == process->mem_req) {
+        append_resident(memory, process);
         return 0;
     }
 
+    // Set bound for minimum pages to allocate
     min_pages = get_min_pages(process);
-    alloc_pages = fair_alloc(memory, arrived, process, min_pages);
 
-    if (memory->empty_pages >= alloc_pages) {
-        load_time = 2 * allocate_memory(memory, process, alloc_pages);
-        process->remaining_time += process->mem_req - process->pages_used;
+    // No need to evict, allocate as many as possible
+    if (memory->empty_pages >= min_pages) {
+        load_time = allocate_all(memory, process);
+        append_resident(memory, process);
         return load_time;
     }
 
-    // Evict 1 page from each arrived process until sufficient space
-    while (memory->empty_pages < alloc_pages) {
-        if ((curr->process->pages_used > MIN_MEM_REQ) ||
-            ((force) && (curr->process->pages_used > 0))) {
-            curr_evicted = evict_memory(memory, curr->process, 1);
-            evicted_pages[num_evicted] = *curr_evicted;
-            num_evicted++;
-            free(curr_evicted);
-        }
-        // Iterated through every arrived processes
-        if (curr->next == NULL) {
-            // Force evict past the MIN_MEM_REQ threshold if needed
-            if (num_evicted == old_evicted) {
-                force = 1;
-            }
-            old_evicted = num_evicted;
-            curr = arrived->head;
-        } else { // Otherwise keep going
-            curr = curr->next;
-        }
+    // Otherwise the hand picks pages of any resident until there is room
+    evicted_pages = (int*)malloc((memory->total_pages)*sizeof(int));
+    num_evicted = clock_evict(memory, min_pages - memory->empty_pages, evicted_pages);
+    if (memory->empty_pages < min_pages) {
+        fprintf(stderr, "Clock found no page to evict. May have gone past foot\n");
     }
     print_evicted(clock, evicted_pages, num_evicted);
+    free(evicted_pages);
+    load_time = 2 * allocate_memory(memory, process, min_pages);
+    append_resident(memory, process);
+    process->remaining_time += process->mem_req - process->pages_used;
+    return load_time;
+}
+
+// Handles memory management by trying to evict equal pages from all arrived processes
+int fair(int clock, Memory *memory, long waiting_time, Process *process)
+{
+    int num_evicted=0;
+    int load_time, min_pages, alloc_pages, needed;
+    int *evicted_pages;
+
+    // The running process is never a victim, and is the most recent once loaded
+    unlink_resident(memory, process);
+    if (process->pages_used == process->mem_req) {
+        append_resident(memory, process);
+        return 0;
+    }
+
+    min_pages = get_min_pages(process);
+    alloc_pages = fair_alloc(memory, waiting_time, process, min_pages);
+    // A process already holding more than its minimum may get a negative share
+    if (alloc_pages < 0) {
+        alloc_pages = 0;
+    }
+    // Pages held by processes running on other cores can't be evicted
+    if (alloc_pages > memory->empty_pages + memory->resident_pages) {
+        alloc_pages = memory->empty_pages + memory->resident_pages;
+    }
+
+    if (memory->empty_pages < alloc_pages) {
+        needed = alloc_pages - memory->empty_pages;
+        evicted_pages = (int*)malloc((memory->total_pages)*sizeof(int));
+        // Take pages evenly from every resident, keeping MIN_MEM_REQ each if possible
+        num_evicted = evict_evenly(memory, needed, MIN_MEM_REQ, evicted_pages);
+        // Force evict past the MIN_MEM_REQ threshold if needed
+        if (num_evicted < needed) {
+            num_evicted += evict_evenly(memory, needed - num_evicted, 0,
+                                        evicted_pages + num_evicted);
+        }
+        print_evicted(clock, evicted_pages, num_evicted);
+        free(evicted_pages);
+    }
     load_time = 2 * allocate_memory(memory, process, alloc_pages);
+    append_resident(memory, process);
     process->remaining_time += process->mem_req - process->pages_used;
     return load_time;
 }
@@ -1,38 +1,95 @@
-#define NUM_OPTIONAL 2
+#define MAX_LEVELS 16
+#define DEFAULT_LEVELS 3
+#define NUM_OPTIONAL (8 + MAX_LEVELS)
 #define MEM_INDX 0
 #define QTM_INDX 1
+#define CORES_INDX 2
+#define LEVELS_INDX 3
+#define BOOST_INDX 4
+#define BUDDY_INDX 5
+#define PCTL_INDX 6
+#define LIMIT_INDX 7 // Clock time after which a sweep run gives up, 0 never does
+#define LEVEL_QTM_INDX 8 // Quantum of each mlfq level, 0 doubles the level above
 #define LINE_BUFF 50
+#define QUIET_OPT 256
+#define SWEEP_OPT 257
+#define STREAM_OPT 258
+#define LEVELS_OPT 259
+#define QUANTA_OPT 260
+#define BOOST_OPT 261
+#define BUDDY_OPT 262
+#define PROFILE_OPT 263
+#define SERIES_OPT 264
+#define PERCENTILES_OPT 265
+#define CHECKPOINT_OPT 266
+#define CHECKPOINT_AT_OPT 267
+#define RESTORE_OPT 268
+#define LIMIT_OPT 269
+#define LOG_THREADS_OPT 270
+#define READ_AHEAD_OPT 271
+#define NUM_PERCENTILES 4
 
 #include <stdio.h>
 #include <unistd.h>
+#include <getopt.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
 #include "statistics.h"
 #include "memory.h"
+#include "process-heap.h"
+#include "output.h"
+#include "trace.h"
+#include "sweep.h"
+#include "multicore.h"
+#include "events.h"
+#include "profile.h"
+#include "checkpoint.h"
 
 
 
 
-void strategy(char *filename, char *sched_alg, char *mem_alloc, int *optionals);
-int fcfs(Deque *process_list, Statistics *stats, Memory *memory,
-         int (*mem_strat)(int, Memory*, Deque*, Process*));
-int round_robin(Deque *process_list, int quantum, Statistics *stats, Memory *memory,
-                int (*mem_strat)(int, Memory*, Deque*, Process*));
-int shortest_first(Deque *process_list, Statistics *stats, Memory *memory,
-                   int (*mem_strat)(int, Memory*, Deque*, Process*));
-// Reads all processes from file
-Deque *read_processes(char *filename);
-void testing(Deque* process_list);
-void print_execution(int clock, Process* process, int load_time, int mem_usage);
-void print_finishing(int clock, int pid, int proc_remaining);
+void strategy(char *filename, char *sched_alg, char *mem_alloc, int *optionals, int log_threads,
+              int streaming, int reading_ahead, int profiling, char *series_file,
+              Checkpoint *checkpoint);
+/* Runs one simulation of process_list and returns its finalised statistics,
+   sampling it into series and saving or restoring checkpoint unless those
+   are NULL */
+Statistics *simulate(Trace *process_list, char *sched_alg, char *mem_alloc, int *optionals,
+                     Series *series, Checkpoint *checkpoint);
+int fcfs(Trace *process_list, Statistics *stats, Memory *memory,
+         int (*mem_strat)(int, Memory*, long, Process*), Checkpoint *checkpoint);
+int round_robin(Trace *process_list, int quantum, Statistics *stats, Memory *memory,
+                int (*mem_strat)(int, Memory*, long, Process*), Checkpoint *checkpoint);
+int shortest_first(Trace *process_list, Statistics *stats, Memory *memory,
+                   int (*mem_strat)(int, Memory*, long, Process*), Checkpoint *checkpoint);
+int srtf(Trace *process_list, Statistics *stats, Memory *memory,
+         int (*mem_strat)(int, Memory*, long, Process*), Checkpoint *checkpoint);
+int mlfq(Trace *process_list, int num_levels, int *quanta, int boost, Statistics *stats,
+         Memory *memory, int (*mem_strat)(int, Memory*, long, Process*),
+         Checkpoint *checkpoint);
+// Moves every process below the top level of mlfq to the back of the top level
+void boost_levels(Deque **levels, int num_levels, unsigned int *nonempty);
+// Returns the total remaining time of the processes waiting over every level of mlfq
+long levels_remaining(Deque **levels, int num_levels);
+void testing(Trace* process_list);
+// The core is only logged when it isn't NO_CORE
+void print_execution(int clock, Process* process, int load_time, int mem_usage, int core);
+void print_finishing(int clock, int pid, int proc_remaining, int core);
 void print_performance(Statistics *stats);
+// Prints percentiles of a histogram on one line, values kept in hundredths with two decimals
+void print_percentiles(char *name, Histogram *histogram, int hundredths);
+// Prints the instrumentation counters and the time spent in each phase of the simulation
+void print_profile();
 void print_evicted(int clock, int *evicted_pages, int num_evicted);
 // Returns updated clock and restructures process_list/arrived as appropriate
-int step(int clock, int step, Deque *process_list, Deque *arrived);
+int step(int clock, int step, Trace *process_list, Deque *arrived);
+// Memory strategies are given the total remaining time of the processes left waiting
 // Handles memory management using Swapping-X and returns load time
-int swapping(int clock, Memory *memory, Deque* arrived, Process *process);
+int swapping(int clock, Memory *memory, long waiting_time, Process *process);
 // Handles memory management using Swapping-X and returns load time
-int virtual(int clock, Memory *memory, Deque* arrived, Process *process);
+int virtual(int clock, Memory *memory, long waiting_time, Process *process);
+// Handles memory management like virtual(), but evicts single pages with the clock algorithm
+int clock_replace(int clock, Memory *memory, long waiting_time, Process *process);
 // Handles memory management by trying to evict equal pages from all arrived processes
-int fair(int clock, Memory *memory, Deque *arrived, Process *process);
+int fair(int clock, Memory *memory, long waiting_time, Process *process);
@@ -0,0 +1,189 @@
+/* Per-interval samples of a simulation, written to CSV or binary files */
+#include "series.h"
+
+
+static const char *columns = "time,finished,dispatches,load_time,peak_mem_usage,peak_queue\n";
+
+
+// Writes out the given number of completed samples
+static void drain(Series *series, Sample *samples, int used) {
+    int i;
+    Sample *sample;
+
+    if (series->binary) {
+        write_all(series->fd, (char*)samples, used*sizeof(Sample));
+        return;
+    }
+    for (i=0; i<used; i++) {
+        sample = &samples[i];
+        buffer_int(&series->text, sample->time);
+        buffer_char(&series->text, ',');
+        buffer_int(&series->text, sample->finished);
+        buffer_char(&series->text, ',');
+        buffer_int(&series->text, sample->dispatches);
+        buffer_char(&series->text, ',');
+        buffer_int(&series->text, sample->load_time);
+        buffer_char(&series->text, ',');
+        buffer_int(&series->text, sample->peak_mem_usage);
+        buffer_char(&series->text, ',');
+        buffer_int(&series->text, sample->peak_queue);
+        buffer_char(&series->text, '\n');
+    }
+}
+
+// Writer thread, drains the rings handed to it until the series is closed
+static void *write_rings(void *arg) {
+    Series *series = (Series*)arg;
+
+    pthread_mutex_lock(&series->lock);
+    while (1) {
+        while ((series->pending < 0) && (!series->closing)) {
+            pthread_cond_wait(&series->changed, &series->lock);
+        }
+        if (series->pending < 0) {
+            break;
+        }
+        pthread_mutex_unlock(&series->lock);
+        drain(series, series->rings[series->pending], series->pending_used);
+        pthread_mutex_lock(&series->lock);
+        series->pending = -1;
+        pthread_cond_broadcast(&series->changed);
+    }
+    pthread_mutex_unlock(&series->lock);
+    return NULL;
+}
+
+// Hands the filling ring to the writer and carries on in the other once it is written
+static void hand_off(Series *series) {
+    pthread_mutex_lock(&series->lock);
+    while (series->pending >= 0) {
+        pthread_cond_wait(&series->changed, &series->lock);
+    }
+    series->pending = series->filling;
+    series->pending_used = series->used;
+    pthread_cond_broadcast(&series->changed);
+    pthread_mutex_unlock(&series->lock);
+    series->filling = (series->filling + 1) % SERIES_RINGS;
+    series->used = 0;
+}
+
+// Starts a new empty sample for the interval starting at time
+static void reset_sample(Series *series, int time) {
+    memset(&series->current, 0, sizeof(Sample));
+    series->current.time = time;
+    series->current.peak_mem_usage = -1;
+}
+
+// Moves the current sample on to the interval clock falls in, completing the old one
+static Sample *sample_at(Series *series, int clock) {
+    // Same intervals as throughput, a finish exactly on a boundary counts towards the earlier one
+    int time = (clock > 0) ? (clock - 1) / series->interval * series->interval : 0;
+
+    // Events never go back in time, those at the same time on other cores stay in this sample
+    if (time <= series->current.time) {
+        return &series->current;
+    }
+    if ((series->current.dispatches > 0) || (series->current.finished > 0)) {
+        series->rings[series->filling][series->used++] = series->current;
+        if (series->used == SERIES_RING) {
+            hand_off(series);
+        }
+    }
+    reset_sample(series, time);
+    return &series->current;
+}
+
+/* Opens filename for a series of samples every interval time units, as binary
+   records if it ends in ".bin" and as CSV otherwise */
+Series *open_series(char *filename, int interval) {
+    size_t length = strlen(filename);
+    int i;
+    SeriesHeader header;
+    Series *series = (Series*)malloc(sizeof(Series));
+
+    series->fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (series->fd < 0) {
+        perror(filename);
+        exit(1);
+    }
+    for (i=0; i<SERIES_RINGS; i++) {
+        series->rings[i] = (Sample*)malloc(SERIES_RING*sizeof(Sample));
+    }
+    series->filling = 0;
+    series->used = 0;
+    series->interval = interval;
+    series->binary = (length >= 4) && (!strcmp(filename + length - 4, ".bin"));
+    series->text.buffer = (char*)malloc(SERIES_TEXT);
+    series->text.used = 0;
+    series->text.capacity = SERIES_TEXT;
+    series->text.fd = series->fd;
+    reset_sample(series, 0);
+
+    if (series->binary) {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SERIES_MAGIC, SERIES_MAGIC_LEN);
+        header.version = SERIES_VERSION;
+        header.header_size = sizeof(header);
+        header.interval = interval;
+        header.fields = SERIES_FIELDS;
+        write_all(series->fd, (char*)&header, sizeof(header));
+    } else {
+        buffer_str(&series->text, columns);
+    }
+
+    series->pending = -1;
+    series->closing = 0;
+    pthread_mutex_init(&series->lock, NULL);
+    pthread_cond_init(&series->changed, NULL);
+    if (pthread_create(&series->writer, NULL, write_rings, series)) {
+        fprintf(stderr, "Failed to start series thread\n");
+        exit(1);
+    }
+    return series;
+}
+
+// Samples a process being put on a core, queued processes are left waiting
+void series_dispatch(Series *series, int clock, int load_time, int mem_usage, int queued) {
+    Sample *sample = sample_at(series, clock);
+
+    sample->dispatches += 1;
+    sample->load_time += load_time;
+    if (mem_usage > sample->peak_mem_usage) {
+        sample->peak_mem_usage = mem_usage;
+    }
+    if (queued > sample->peak_queue) {
+        sample->peak_queue = queued;
+    }
+}
+
+// Samples a process finishing
+void series_finish(Series *series, int clock) {
+    sample_at(series, clock)->finished += 1;
+}
+
+// Writes out every sample left, closes the file and frees the series
+void close_series(Series *series) {
+    int i;
+
+    if ((series->current.dispatches > 0) || (series->current.finished > 0)) {
+        series->rings[series->filling][series->used++] = series->current;
+    }
+    if (series->used > 0) {
+        hand_off(series);
+    }
+    pthread_mutex_lock(&series->lock);
+    series->closing = 1;
+    pthread_cond_broadcast(&series->changed);
+    pthread_mutex_unlock(&series->lock);
+    pthread_join(series->writer, NULL);
+
+    write_all(series->fd, series->text.buffer, series->text.used);
+    close(series->fd);
+    pthread_mutex_destroy(&series->lock);
+    pthread_cond_destroy(&series->changed);
+    free(series->text.buffer);
+    for (i=0; i<SERIES_RINGS; i++) {
+        free(series->rings[i]);
+    }
+    free(series);
+}
@@ -0,0 +1,81 @@
+#ifndef SERIES_H
+#define SERIES_H
+#define SERIES_RING 4096
+#define SERIES_RINGS 2
+#define SERIES_MAGIC "SCHSERIE"
+#define SERIES_MAGIC_LEN 8
+#define SERIES_VERSION 1
+#define SERIES_FIELDS 6
+#define SERIES_TEXT (1 << 16)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "output.h"
+
+/* Time series export. Events are folded into one sample per throughput
+   interval and completed samples queue up in rings allocated up front. A full
+   ring is handed to a writer thread, which turns it into CSV text or writes it
+   out as binary records while the simulation fills the other, so sampling
+   itself never allocates, formats or writes. Intervals in which nothing ran
+   or finished get no sample. */
+
+typedef struct sample Sample;
+typedef struct series_header SeriesHeader;
+typedef struct series Series;
+
+// One interval, also the layout of a binary record
+struct sample {
+    int32_t time; // Start of the interval, which covers (time, time + INTRVL_RANGE]
+    int32_t finished;
+    int32_t dispatches; // Processes put on a core
+    int32_t load_time; // Total over the dispatches
+    int32_t peak_mem_usage; // Percentage after loading, -1 for unlimited memory
+    int32_t peak_queue; // Processes left waiting by a dispatch
+};
+
+/* Binary series layout: this header, then SERIES_FIELDS int32 fields per
+   sample in Sample order, starting header_size bytes into the file */
+struct series_header {
+    char magic[SERIES_MAGIC_LEN];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t interval; // Time units each sample covers
+    uint32_t fields;
+};
+
+struct series {
+    Sample *rings[SERIES_RINGS]; // SERIES_RING completed samples each
+    int filling; // Ring the simulation adds samples to
+    int used;
+    int interval;
+    Sample current; // Interval being sampled, empty while dispatches and finished are 0
+    int binary;
+    int fd;
+    Output text; // Holds CSV lines on their way to fd, only used by the writer
+    int pending; // Ring handed to the writer, -1 once it is written
+    int pending_used;
+    int closing;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+};
+
+/* Opens filename for a series of samples every interval time units, as binary
+   records if it ends in ".bin" and as CSV otherwise */
+Series *open_series(char *filename, int interval);
+
+// Samples a process being put on a core, queued processes are left waiting
+void series_dispatch(Series *series, int clock, int load_time, int mem_usage, int queued);
+
+// Samples a process finishing
+void series_finish(Series *series, int clock);
+
+// Writes out every sample left, closes the file and frees the series
+void close_series(Series *series);
+
+#endif
@@ -1,7 +1,8 @@
 #include "statistics.h"
 
 
-Statistics *init_stats() {
+Statistics *init_stats(int cores) {
+    int i;
     Statistics *new_stats;
     new_stats = (Statistics*)malloc(sizeof(Statistics));
 
@@ -19,10 +20,64 @@ Statistics *init_stats() {
     new_stats->overhead[OVR_AVG] = 0.0;
     new_stats->makespan = 0;
     new_stats->finished_processes = 0;
+    new_stats->num_cores = cores;
+    new_stats->core_busy = (long*)calloc(cores, sizeof(long));
+    new_stats->num_levels = 0;
+    new_stats->level_turnaround = NULL;
+    new_stats->level_finished = NULL;
+    new_stats->pages_loaded = 0;
+    new_stats->reports_loads = 0;
+    new_stats->reports_fragmentation = 0;
+    new_stats->largest_free[LF_MIN] = 0.0;
+    new_stats->largest_free[LF_AVG] = 0.0;
+    new_stats->fragmentation[FRAG_MAX] = 0.0;
+    new_stats->fragmentation[FRAG_AVG] = 0.0;
+    new_stats->series = NULL;
+    for (i=0; i<NUM_HISTS; i++) {
+        new_stats->histograms[i] = NULL;
+    }
+    new_stats->time_limit = 0;
+    new_stats->timed_out = 0;
 
     return new_stats;
 }
 
+void free_stats(Statistics *stats) {
+    int i;
+
+    for (i=0; i<NUM_HISTS; i++) {
+        if (stats->histograms[i] != NULL) {
+            free_histogram(stats->histograms[i]);
+        }
+    }
+    free(stats->core_busy);
+    free(stats->level_turnaround);
+    free(stats->level_finished);
+    free(stats);
+}
+
+// Starts keeping turnaround per mlfq level
+void track_levels(Statistics *stats, int levels) {
+    stats->num_levels = levels;
+    stats->level_turnaround = (long*)calloc(levels, sizeof(long));
+    stats->level_finished = (int*)calloc(levels, sizeof(int));
+}
+
+// Starts keeping the turnaround, overhead and waiting time of every process in histograms
+void track_percentiles(Statistics *stats) {
+    int i;
+
+    for (i=0; i<NUM_HISTS; i++) {
+        stats->histograms[i] = new_histogram();
+    }
+}
+
+// Adds a completed process to the turnaround of the level it finished on
+void update_level_stats(int clock, Statistics *stats, Process *process, int level) {
+    stats->level_turnaround[level] += clock - process->arrival_time;
+    stats->level_finished[level] += 1;
+}
+
 // Updates stats when a process has been completed
 void update_stats(int clock, Statistics *stats, Process *process) {
     int process_turnaround, interval;
@@ -38,6 +93,16 @@ void update_stats(int clock, Statistics *stats, Process *process) {
     if (process_overhead > stats->overhead[OVR_MAX]) {
         stats->overhead[OVR_MAX] = process_overhead;
     }
+    if (stats->series != NULL) {
+        series_finish(stats->series, clock);
+    }
+    // Waiting covers every time unit the process spent not running its own job
+    if (stats->histograms[HIST_TURNAROUND] != NULL) {
+        histogram_record(stats->histograms[HIST_TURNAROUND], clock - process->arrival_time);
+        histogram_record(stats->histograms[HIST_OVERHEAD], (long)(process_overhead * 100 + 0.5));
+        histogram_record(stats->histograms[HIST_WAITING],
+                         clock - process->arrival_time - process->job_time);
+    }
 
     // Update throughput on new 60s interval
     interval = (clock-1) / INTRVL_RANGE;
@@ -65,6 +130,22 @@ void update_stats(int clock, Statistics *stats, Process *process) {
     return;
 }
 
+// Records a process being put on a core, leaving queued processes waiting
+void update_dispatch_stats(int clock, Statistics *stats, int load_time, int mem_usage,
+                           int queued) {
+    if (stats->series != NULL) {
+        series_dispatch(stats->series, clock, load_time, mem_usage, queued);
+    }
+}
+
+// Checks whether the run has gone past its time limit, marking it as timed out if so
+int out_of_time(Statistics *stats, int clock) {
+    if ((stats->time_limit > 0) && (clock > stats->time_limit)) {
+        stats->timed_out = 1;
+    }
+    return stats->timed_out;
+}
+
 // Calculate the averages and assign makespan once all processes are finished
 void finalise_stats(int clock, Statistics *stats) {
     stats->makespan = clock;
@@ -90,3 +171,20 @@ int rounded_average(int numerator, int divisor) {
     }
     return int_avg;
 }
+
+// Returns the percentage of the makespan a core was busy, rounded up
+int core_utilisation(Statistics *stats, int core) {
+    if (stats->makespan == 0) {
+        return 0;
+    }
+    return (stats->core_busy[core]*100 + stats->makespan - 1) / stats->makespan;
+}
+
+// Returns the average turnaround of a level, rounded up
+int level_turnaround(Statistics *stats, int level) {
+    if (stats->level_finished[level] == 0) {
+        return 0;
+    }
+    return (stats->level_turnaround[level] + stats->level_finished[level] - 1)
+           / stats->level_finished[level];
+}
@@ -7,11 +7,21 @@
 #define TH_PROC 4
 #define OVR_MAX 0
 #define OVR_AVG 1
+#define LF_MIN 0
+#define LF_AVG 1
+#define FRAG_MAX 0
+#define FRAG_AVG 1
+#define HIST_TURNAROUND 0
+#define HIST_OVERHEAD 1 // Recorded in hundredths
+#define HIST_WAITING 2
+#define NUM_HISTS 3
 #define INTRVL_RANGE 60
 
 #include <stdio.h>
 #include <stdlib.h>
 #include "process-deque.h"
+#include "series.h"
+#include "histogram.h"
 
 typedef struct statistics Statistics;
 
@@ -21,13 +31,45 @@ struct statistics {
     float overhead[2];
     int makespan;
     int finished_processes;
+    int num_cores;
+    long *core_busy; // Time each core spent loading and running processes
+    int num_levels; // Only mlfq tracks levels, 0 otherwise
+    long *level_turnaround; // Total turnaround of the processes finishing on each level
+    int *level_finished;
+    long pages_loaded;
+    int reports_loads; // Only the clock strategy prints pages_loaded
+    // Sampled after each buddy allocation, only printed for the buddy backend
+    int reports_fragmentation;
+    float largest_free[2]; // In pages
+    float fragmentation[2]; // Percentage of empty pages outside the largest free block
+    Series *series; // Per-interval samples are only exported when not NULL
+    // Per-process distributions, only kept and printed after track_percentiles()
+    Histogram *histograms[NUM_HISTS];
+    int time_limit; // Clock time after which the run gives up, 0 never does
+    int timed_out; // Set once the run has given up, leaving the averages unfinalised
 };
 
-Statistics *init_stats();
+Statistics *init_stats(int cores);
+void free_stats(Statistics *stats);
+// Starts keeping turnaround per mlfq level
+void track_levels(Statistics *stats, int levels);
+// Starts keeping the turnaround, overhead and waiting time of every process in histograms
+void track_percentiles(Statistics *stats);
+// Adds a completed process to the turnaround of the level it finished on
+void update_level_stats(int clock, Statistics *stats, Process *process, int level);
+// Returns the average turnaround of a level, rounded up
+int level_turnaround(Statistics *stats, int level);
 // Updates stats when a process has been completed
 void update_stats(int clock, Statistics *stats, Process *process);
+// Records a process being put on a core, leaving queued processes waiting
+void update_dispatch_stats(int clock, Statistics *stats, int load_time, int mem_usage,
+                           int queued);
+// Checks whether the run has gone past its time limit, marking it as timed out if so
+int out_of_time(Statistics *stats, int clock);
 // Assign makespan and averages once all processes are finished
 void finalise_stats(int clock, Statistics *stats);
+// Returns the percentage of the makespan a core was busy, rounded up
+int core_utilisation(Statistics *stats, int core);
 // Calculates average and rounds up to an integer
 int rounded_average(int numerator, int divisor);
 
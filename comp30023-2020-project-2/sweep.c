@@ -0,0 +1,246 @@
+#include "scheduler.h"
+
+
+// Splits a comma separated list in place, returning the number of items
+static int split_list(char *list, char **items) {
+    int count = 0;
+    char *save;
+    char *item = strtok_r(list, ",", &save);
+
+    while (item != NULL) {
+        if (count == SWEEP_LIST_MAX) {
+            fprintf(stderr, "Too many values in sweep list, at most %d\n", SWEEP_LIST_MAX);
+            exit(1);
+        }
+        items[count++] = item;
+        item = strtok_r(NULL, ",", &save);
+    }
+    return count;
+}
+
+// Claims runs until none are left, each simulated over its own view of the trace
+static void *sweep_worker(void *arg) {
+    Sweep *sweep = (Sweep*)arg;
+    SweepRun *run;
+    Arena *arena;
+    Trace *view;
+    int i;
+
+    while (1) {
+        pthread_mutex_lock(&sweep->lock);
+        i = sweep->next_run++;
+        pthread_mutex_unlock(&sweep->lock);
+        if (i >= sweep->num_runs) {
+            break;
+        }
+        run = &sweep->runs[i];
+        // Processes of this run only, freed as soon as it finishes
+        arena = new_arena();
+        view = view_trace(sweep->trace, arena);
+        run->stats = simulate(view, run->sched_alg, run->mem_alloc, run->optionals, NULL, NULL);
+        free_trace(view);
+        free_arena(arena);
+
+        pthread_mutex_lock(&sweep->lock);
+        run->done = 1;
+        pthread_cond_broadcast(&sweep->finished);
+        pthread_mutex_unlock(&sweep->lock);
+    }
+    return NULL;
+}
+
+// Returns the clock limit of every run when none is given, 0 for no limit
+static int default_limit(Trace *trace) {
+    int i;
+    long total_time = 0;
+    long limit;
+
+    if (trace->count == 0) {
+        return 0;
+    }
+    for (i=0; i<trace->count; i++) {
+        total_time += trace->columns[JOB_TIME][i];
+    }
+    limit = trace->columns[ARRIVED][trace->count-1] + SWEEP_SLOWDOWN*total_time;
+    return (limit > INT_MAX) ? INT_MAX : (int)limit;
+}
+
+// Prints the performance of a finished run as one CSV row, with no metrics if it timed out
+static void print_row(SweepRun *run) {
+    char line[SWEEP_LINE];
+    Statistics *stats = run->stats;
+
+    if (stats->timed_out) {
+        snprintf(line, sizeof(line), "%s,%s,%d,%d,%d,,,,,,,,,timeout\n",
+                 run->sched_alg, run->mem_alloc, run->optionals[MEM_INDX],
+                 run->optionals[QTM_INDX], run->optionals[CORES_INDX]);
+    } else {
+        snprintf(line, sizeof(line), "%s,%s,%d,%d,%d,%d,%d,%d,%d,%.2f,%.2f,%d,%ld,ok\n",
+                 run->sched_alg, run->mem_alloc, run->optionals[MEM_INDX],
+                 run->optionals[QTM_INDX], run->optionals[CORES_INDX], stats->throughput[TH_AVG],
+                 stats->throughput[TH_MIN], stats->throughput[TH_MAX], stats->turnaround,
+                 stats->overhead[OVR_MAX], stats->overhead[OVR_AVG], stats->makespan,
+                 stats->pages_loaded);
+    }
+    output_str(line);
+}
+
+// Simulates every combination of the comma separated lists and prints them as CSV
+void sweep(char *filename, char *sched_algs, char *mem_allocs, char *mem_sizes,
+           char *quanta, char *core_counts, int threads, int limit) {
+    char *algs[SWEEP_LIST_MAX], *allocs[SWEEP_LIST_MAX];
+    char *sizes[SWEEP_LIST_MAX], *qtms[SWEEP_LIST_MAX], *cores[SWEEP_LIST_MAX];
+    char default_algs[] = "ff,rr,cs", default_allocs[] = "u,p,v,cm", unlimited[] = "u";
+    char default_sizes[] = "0", default_qtms[] = "10", default_cores[] = "1";
+    int num_algs, num_allocs, num_sizes, num_qtms, num_cores;
+    int a, m, s, q, c, i;
+    Sweep sweep;
+    Arena *arena;
+    pthread_t *workers;
+
+    // Any list left out sweeps over its defaults, limited memory only once there are sizes
+    if (mem_allocs == NULL) {
+        mem_allocs = (mem_sizes == NULL) ? unlimited : default_allocs;
+    }
+    num_algs = split_list((sched_algs == NULL) ? default_algs : sched_algs, algs);
+    num_allocs = split_list(mem_allocs, allocs);
+    num_sizes = split_list((mem_sizes == NULL) ? default_sizes : mem_sizes, sizes);
+    num_qtms = split_list((quanta == NULL) ? default_qtms : quanta, qtms);
+    num_cores = split_list((core_counts == NULL) ? default_cores : core_counts, cores);
+
+    for (a=0; a<num_algs; a++) {
+        if (strcmp(algs[a], "ff") && strcmp(algs[a], "rr") && strcmp(algs[a], "cs") &&
+            strcmp(algs[a], "mlfq") && strcmp(algs[a], "srtf")) {
+            fprintf(stderr, "Unknown scheduling algorithm %s\n", algs[a]);
+            exit(1);
+        }
+    }
+    for (c=0; c<num_cores; c++) {
+        if (atoi(cores[c]) < 1) {
+            fprintf(stderr, "Core counts must be at least 1\n");
+            exit(1);
+        }
+    }
+    for (q=0; q<num_qtms; q++) {
+        if (atoi(qtms[q]) < 1) {
+            fprintf(stderr, "Quanta must be at least 1\n");
+            exit(1);
+        }
+    }
+    for (m=0; m<num_allocs; m++) {
+        if (strcmp(allocs[m], "u") && strcmp(allocs[m], "p") &&
+            strcmp(allocs[m], "v") && strcmp(allocs[m], "cm") &&
+            strcmp(allocs[m], "clock")) {
+            fprintf(stderr, "Unknown memory allocation %s\n", allocs[m]);
+            exit(1);
+        }
+        if (strcmp(allocs[m], "u")) {
+            for (s=0; s<num_sizes; s++) {
+                if (atoi(sizes[s]) < 1) {
+                    fprintf(stderr, "Memory allocation %s needs memory sizes of at least 1\n",
+                            allocs[m]);
+                    exit(1);
+                }
+            }
+        }
+    }
+
+    /* Size only matters with limited memory and quantum only to rr and mlfq,
+       so combinations differing in an ignored option are simulated once.
+       mlfq runs with its default levels, and it and srtf only run on one core */
+    sweep.runs = (SweepRun*)malloc(num_algs*num_allocs*num_sizes*num_qtms*num_cores
+                                   *sizeof(SweepRun));
+    sweep.num_runs = 0;
+    for (a=0; a<num_algs; a++) {
+        for (m=0; m<num_allocs; m++) {
+            for (s=0; s<num_sizes; s++) {
+                if ((!strcmp(allocs[m], "u")) && (s > 0)) {
+                    break;
+                }
+                for (q=0; q<num_qtms; q++) {
+                    if ((strcmp(algs[a], "rr")) && (strcmp(algs[a], "mlfq")) && (q > 0)) {
+                        break;
+                    }
+                    for (c=0; c<num_cores; c++) {
+                        if (((!strcmp(algs[a], "mlfq")) || (!strcmp(algs[a], "srtf"))) &&
+                            (atoi(cores[c]) > 1)) {
+                            continue;
+                        }
+                        memset(sweep.runs[sweep.num_runs].optionals, 0,
+                               sizeof(sweep.runs[sweep.num_runs].optionals));
+                        sweep.runs[sweep.num_runs].optionals[LEVELS_INDX] = DEFAULT_LEVELS;
+                        sweep.runs[sweep.num_runs].sched_alg = algs[a];
+                        sweep.runs[sweep.num_runs].mem_alloc = allocs[m];
+                        sweep.runs[sweep.num_runs].optionals[MEM_INDX] =
+                            (!strcmp(allocs[m], "u")) ? 0 : atoi(sizes[s]);
+                        sweep.runs[sweep.num_runs].optionals[QTM_INDX] =
+                            ((!strcmp(algs[a], "rr")) || (!strcmp(algs[a], "mlfq"))) ?
+                            atoi(qtms[q]) : 0;
+                        sweep.runs[sweep.num_runs].optionals[CORES_INDX] = atoi(cores[c]);
+                        sweep.runs[sweep.num_runs].done = 0;
+                        sweep.num_runs++;
+                    }
+                }
+            }
+        }
+    }
+
+    if (threads <= 0) {
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (threads > sweep.num_runs) {
+        threads = sweep.num_runs;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    // Only the summaries are wanted, and runs can't share the event log
+    quiet = 1;
+    arena = new_arena();
+    sweep.trace = load_trace(filename, arena);
+    sweep.next_run = 0;
+    pthread_mutex_init(&sweep.lock, NULL);
+    pthread_cond_init(&sweep.finished, NULL);
+
+    // Runs left without a limit of their own give up well past any finishing run
+    if (limit < 0) {
+        limit = default_limit(sweep.trace);
+    }
+    for (i=0; i<sweep.num_runs; i++) {
+        sweep.runs[i].optionals[LIMIT_INDX] = limit;
+    }
+
+    workers = (pthread_t*)malloc(threads*sizeof(pthread_t));
+    for (i=0; i<threads; i++) {
+        if (pthread_create(&workers[i], NULL, sweep_worker, &sweep)) {
+            fprintf(stderr, "Failed to start sweep thread\n");
+            exit(1);
+        }
+    }
+
+    // Rows go out in list order as soon as each run is done
+    output_str("sched,mem,size,quantum,cores,throughput_avg,throughput_min,throughput_max,"
+               "turnaround,overhead_max,overhead_avg,makespan,pages_loaded,status\n");
+    flush_output();
+    for (i=0; i<sweep.num_runs; i++) {
+        pthread_mutex_lock(&sweep.lock);
+        while (!sweep.runs[i].done) {
+            pthread_cond_wait(&sweep.finished, &sweep.lock);
+        }
+        pthread_mutex_unlock(&sweep.lock);
+        print_row(&sweep.runs[i]);
+        flush_output();
+        free_stats(sweep.runs[i].stats);
+    }
+    for (i=0; i<threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    pthread_cond_destroy(&sweep.finished);
+    pthread_mutex_destroy(&sweep.lock);
+    free(workers);
+    free(sweep.runs);
+    free_trace(sweep.trace);
+    free_arena(arena);
+}
@@ -0,0 +1,49 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+#define SWEEP_LIST_MAX 32
+#define SWEEP_LINE 160
+#define SWEEP_SLOWDOWN 1000 // Default limit on a run's makespan, in multiples of total job time
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "statistics.h"
+#include "trace.h"
+#include "arena.h"
+#include "output.h"
+
+/* Parameter sweep. Every combination of scheduling algorithm, memory
+   allocation, memory size, quantum and core count is simulated over the same trace by a
+   pool of threads, and one CSV row of performance metrics is printed per
+   combination, in the order the combinations were listed, as soon as it and the
+   rows before it are done. Some configurations never finish, such as rr with a
+   quantum too short to cover its page faults, so a run still going at its clock
+   limit is given up and its row reports it as timed out. */
+
+typedef struct sweep_run SweepRun;
+typedef struct sweep Sweep;
+
+struct sweep_run {
+    char *sched_alg;
+    char *mem_alloc;
+    int optionals[NUM_OPTIONAL]; // Memory size, quantum, cores and mlfq levels, as in main()
+    Statistics *stats;
+    int done; // Set once stats hold the finished run
+};
+
+struct sweep {
+    Trace *trace; // Shared, read only
+    SweepRun *runs;
+    int num_runs;
+    int next_run; // Next run to be claimed by a worker
+    pthread_mutex_t lock;
+    pthread_cond_t finished; // Signalled whenever a run is done
+};
+
+// Simulates every combination of the comma separated lists and prints them as CSV
+void sweep(char *filename, char *sched_algs, char *mem_allocs, char *mem_sizes,
+           char *quanta, char *core_counts, int threads, int limit);
+
+#endif
@@ -0,0 +1,25 @@
+/* Converts a text process trace to the binary trace format so repeated
+   simulations can map it in place instead of parsing it again.
+   Usage: trace-convert <text trace> <binary trace> */
+#include "trace.h"
+
+
+int main(int argc, char **argv)
+{
+    Arena *arena;
+    Trace *trace;
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <text trace> <binary trace>\n", argv[0]);
+        exit(1);
+    }
+
+    arena = new_arena();
+    trace = load_trace(argv[1], arena);
+    write_trace(trace, argv[2]);
+    printf("%d processes written to %s\n", trace->count, argv[2]);
+
+    free_trace(trace);
+    free_arena(arena);
+    return 0;
+}
@@ -0,0 +1,750 @@
+/* Loads process traces of (time arrived, process id, memory size, job time) tuples,
+   either as text lines or in the binary column format described in trace.h */
+#include "trace.h"
+
+
+// Parses one newline terminated line of 4-tuples into fields and moves the cursor to
+// the next line. Returns the number of fields, or -1 if the line is malformed
+static int parse_line(const char **cursor, long *fields) {
+    const char *c = *cursor;
+    const char *start;
+    int num_fields = 0;
+    unsigned long value;
+    unsigned digit;
+
+    for (;;) {
+        // Separators are spaces, tabs and the carriage returns of CRLF files
+        while ((*c == ' ') || (*c == '\t') || (*c == '\r')) {
+            c++;
+        }
+        if (*c == '\n') {
+            break;
+        }
+        start = c;
+        value = 0;
+        while ((digit = (unsigned char)*c - '0') <= 9) {
+            value = value*10 + digit;
+            c++;
+        }
+        // A field is a run of digits that fits an int and ends at a separator
+        if ((c == start) || (c - start > MAX_DIGITS) || (value > INT_MAX) ||
+            ((*c != ' ') && (*c != '\t') && (*c != '\r') && (*c != '\n'))) {
+            num_fields = -1;
+            break;
+        }
+        if (num_fields < NUM_FIELDS) {
+            fields[num_fields] = value;
+        }
+        num_fields++;
+    }
+
+    while (*c != '\n') {
+        c++;
+    }
+    *cursor = c + 1;
+    return num_fields;
+}
+
+// Orders by process id, falling back on the original position for duplicate ids
+static int pid_comp(const void *first, const void *second) {
+    const int32_t *x = (const int32_t*)first;
+    const int32_t *y = (const int32_t*)second;
+    if (x[0] != y[0]) {
+        return (x[0] < y[0]) ? -1 : 1;
+    }
+    return x[1] - y[1];
+}
+
+// Resolve order of same-time process arrivals by process id, for those from first to last
+static void order_rows(Trace *trace, int first, int last) {
+    int i, j, field, run_start=first;
+    int32_t *keys, *moved;
+    int32_t *arrival_time = trace->columns[ARRIVED];
+    int32_t *pid = trace->columns[ID];
+
+    for (i=first+1; i<=last; i++) {
+        if ((i < last) && (arrival_time[i] == arrival_time[run_start])) {
+            continue;
+        }
+        // Most runs are a single process or already in order
+        for (j=run_start+1; (j < i) && (pid[j-1] <= pid[j]); j++);
+        if (j < i) {
+            keys = (int32_t*)malloc(2*(i - run_start)*sizeof(int32_t));
+            moved = (int32_t*)malloc((i - run_start)*sizeof(int32_t));
+            for (j=run_start; j<i; j++) {
+                keys[2*(j - run_start)] = pid[j];
+                keys[2*(j - run_start) + 1] = j;
+            }
+            qsort(keys, i - run_start, 2*sizeof(int32_t), pid_comp);
+            for (field=0; field<NUM_FIELDS; field++) {
+                for (j=0; j<i-run_start; j++) {
+                    moved[j] = trace->columns[field][keys[2*j + 1]];
+                }
+                memcpy(trace->columns[field] + run_start, moved,
+                       (i - run_start)*sizeof(int32_t));
+            }
+            free(keys);
+            free(moved);
+        }
+        run_start = i;
+    }
+}
+
+// Resolve order of same-time process arrivals by process id
+static void order_trace(Trace *trace) {
+    order_rows(trace, 0, trace->count);
+}
+
+// Gives the trace writable columns with room for count processes
+static void own_columns(Trace *trace, int count) {
+    int field;
+
+    trace->owned = (int32_t*)malloc((size_t)NUM_FIELDS*count*sizeof(int32_t));
+    for (field=0; field<NUM_FIELDS; field++) {
+        trace->columns[field] = trace->owned + (size_t)field*count;
+    }
+}
+
+// Parses a text trace mapped at text into the trace's own columns
+static void parse_text(Trace *trace, char *filename, const char *text, size_t size) {
+    int num_fields, field;
+    long line_number=0, max_lines=0, num_malformed=0;
+    long fields[NUM_FIELDS];
+    const char *cursor, *end = text + size;
+    const char *last_line = text;
+    char *tail = NULL;
+
+    // Every line may hold a process, size the columns from the line count
+    for (cursor=text; (cursor = memchr(cursor, '\n', end - cursor)) != NULL; cursor++) {
+        max_lines++;
+        last_line = cursor + 1;
+    }
+    // An unterminated last line is parsed from a terminated copy
+    if (last_line < end) {
+        max_lines++;
+        tail = (char*)malloc(end - last_line + 1);
+        memcpy(tail, last_line, end - last_line);
+        tail[end - last_line] = '\n';
+    }
+    own_columns(trace, max_lines);
+
+    cursor = text;
+    while (line_number < max_lines) {
+        if (cursor == last_line) {
+            cursor = tail;
+        }
+        line_number++;
+        num_fields = parse_line(&cursor, fields);
+        if (num_fields == 0) {
+            // Blank line
+            continue;
+        }
+        if (num_fields != NUM_FIELDS) {
+            num_malformed++;
+            if (num_malformed <= MAX_REPORTED) {
+                fprintf(stderr, "%s:%ld: expected 4 non-negative integers "
+                        "(time arrived, process id, memory size, job time)\n",
+                        filename, line_number);
+            }
+            continue;
+        }
+        for (field=0; field<NUM_FIELDS; field++) {
+            trace->columns[field][trace->count] = fields[field];
+        }
+        trace->count++;
+    }
+    free(tail);
+
+    if (num_malformed > 0) {
+        if (num_malformed > MAX_REPORTED) {
+            fprintf(stderr, "%s: %ld more malformed lines\n", filename,
+                    num_malformed - MAX_REPORTED);
+        }
+        exit(1);
+    }
+    order_trace(trace);
+}
+
+// Points the trace's columns into a mapped binary trace
+static void map_binary(Trace *trace, char *filename) {
+    int field;
+    TraceHeader *header = (TraceHeader*)trace->mapping;
+    char *data = (char*)trace->mapping;
+
+    if ((trace->mapping_size < sizeof(TraceHeader)) || (header->version != TRACE_VERSION) ||
+        (header->count > INT_MAX) || (header->header_size < sizeof(TraceHeader)) ||
+        (header->header_size + NUM_FIELDS*header->count*sizeof(int32_t) > trace->mapping_size)) {
+        fprintf(stderr, "%s: unsupported or truncated binary trace\n", filename);
+        exit(1);
+    }
+    trace->count = header->count;
+    for (field=0; field<NUM_FIELDS; field++) {
+        trace->columns[field] = (int32_t*)(data + header->header_size
+                                           + (size_t)field*trace->count*sizeof(int32_t));
+    }
+
+    // Columns from other writers may still need ordering, which needs a writable copy
+    if (!(header->flags & TRACE_ORDERED)) {
+        own_columns(trace, trace->count);
+        for (field=0; field<NUM_FIELDS; field++) {
+            memcpy(trace->owned + (size_t)field*trace->count,
+                   data + header->header_size + (size_t)field*trace->count*sizeof(int32_t),
+                   trace->count*sizeof(int32_t));
+        }
+        order_trace(trace);
+    }
+}
+
+// Loads a text or binary trace, told apart by the magic number, with records coming from arena
+Trace *load_trace(char *filename, Arena *arena) {
+    int fd;
+    struct stat file_stat;
+    Trace *trace = (Trace*)calloc(1, sizeof(Trace));
+
+    trace->arena = arena;
+    trace->fd = -1;
+    fd = open(filename, O_RDONLY);
+    if ((fd < 0) || (fstat(fd, &file_stat) < 0)) {
+        fprintf(stderr, "Could not open %s: %s\n", filename, strerror(errno));
+        exit(1);
+    }
+    if (file_stat.st_size == 0) {
+        close(fd);
+        return trace;
+    }
+    trace->mapping_size = file_stat.st_size;
+    trace->mapping = mmap(NULL, trace->mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (trace->mapping == MAP_FAILED) {
+        fprintf(stderr, "Could not map %s: %s\n", filename, strerror(errno));
+        exit(1);
+    }
+
+    if ((trace->mapping_size >= TRACE_MAGIC_LEN) &&
+        (!memcmp(trace->mapping, TRACE_MAGIC, TRACE_MAGIC_LEN))) {
+        map_binary(trace, filename);
+        if (trace->owned == NULL) {
+            // Columns are read once, front to back, as processes arrive
+            madvise(trace->mapping, trace->mapping_size, MADV_SEQUENTIAL);
+        }
+    } else {
+        madvise(trace->mapping, trace->mapping_size, MADV_SEQUENTIAL);
+        parse_text(trace, filename, (const char*)trace->mapping, trace->mapping_size);
+    }
+
+    // The text itself is no longer needed once parsed
+    if (trace->owned != NULL) {
+        munmap(trace->mapping, trace->mapping_size);
+        trace->mapping = NULL;
+    }
+    trace->ready = trace->count;
+    return trace;
+}
+
+// Makes room in a streamed trace's columns for rows more processes
+static void reserve_rows(Trace *trace, int rows) {
+    int field, capacity = trace->capacity;
+    int32_t *owned;
+
+    if (trace->count + rows <= capacity) {
+        return;
+    }
+    while (capacity < trace->count + rows) {
+        capacity = (capacity == 0) ? STREAM_ROWS : 2*capacity;
+    }
+    owned = (int32_t*)malloc((size_t)NUM_FIELDS*capacity*sizeof(int32_t));
+    if (owned == NULL) {
+        fprintf(stderr, "Out of memory buffering %s\n", trace->filename);
+        exit(1);
+    }
+    for (field=0; field<NUM_FIELDS; field++) {
+        if (trace->count > 0) {
+            memcpy(owned + (size_t)field*capacity, trace->columns[field],
+                   trace->count*sizeof(int32_t));
+        }
+        trace->columns[field] = owned + (size_t)field*capacity;
+    }
+    free(trace->owned);
+    trace->owned = owned;
+    trace->capacity = capacity;
+}
+
+// Drops the columns of processes that have already arrived
+static void compact(Trace *trace) {
+    int field;
+
+    if (trace->next == 0) {
+        return;
+    }
+    for (field=0; field<NUM_FIELDS; field++) {
+        memmove(trace->columns[field], trace->columns[field] + trace->next,
+                (trace->count - trace->next)*sizeof(int32_t));
+    }
+    trace->base += trace->next;
+    trace->count -= trace->next;
+    trace->ready -= trace->next;
+    trace->next = 0;
+}
+
+/* Reads up to size bytes into buffer, stopping early only at the end of the file.
+   Returns -1 if reading fails, with the reason in trace->failure */
+static long read_fully(Trace *trace, char *buffer, size_t size) {
+    size_t done = 0;
+    ssize_t result;
+
+    while (done < size) {
+        result = read(trace->fd, buffer + done, size - done);
+        if ((result < 0) && (errno == EINTR)) {
+            continue;
+        }
+        if (result < 0) {
+            snprintf(trace->failure, FAILURE_LEN, "Could not read %s: %s\n", trace->filename,
+                     strerror(errno));
+            return -1;
+        }
+        if (result == 0) {
+            break;
+        }
+        done += result;
+    }
+    return done;
+}
+
+/* Parses the next piece of a streamed text trace, returns 0 once the file is
+   exhausted and -1 if it can't be read, with the reason in trace->failure */
+static int read_text(Trace *trace) {
+    int num_fields, field;
+    long fields[NUM_FIELDS];
+    long got;
+    const char *cursor, *end;
+
+    // Leave room for the newline an unterminated last line is given
+    if (trace->chunk_used + 1 >= trace->chunk_size) {
+        trace->chunk_size *= 2;
+        trace->chunk = (char*)realloc(trace->chunk, trace->chunk_size);
+    }
+    got = read_fully(trace, trace->chunk + trace->chunk_used,
+                     trace->chunk_size - trace->chunk_used - 1);
+    if (got < 0) {
+        return -1;
+    }
+    if ((got == 0) && (trace->chunk_used == 0)) {
+        return 0;
+    }
+    trace->chunk_used += got;
+    if ((got == 0) && (trace->chunk[trace->chunk_used - 1] != '\n')) {
+        trace->chunk[trace->chunk_used++] = '\n';
+    }
+
+    // Only whole lines are parsed, the rest waits for the next piece
+    for (end=trace->chunk + trace->chunk_used - 1; (end >= trace->chunk) && (*end != '\n'); end--);
+    if (end < trace->chunk) {
+        return 1;
+    }
+    cursor = trace->chunk;
+    while (cursor <= end) {
+        trace->line_number++;
+        num_fields = parse_line(&cursor, fields);
+        if (num_fields == 0) {
+            // Blank line
+            continue;
+        }
+        // Later lines aren't read yet, so the first malformed one ends the run
+        if (num_fields != NUM_FIELDS) {
+            snprintf(trace->failure, FAILURE_LEN, "%s:%ld: expected 4 non-negative integers "
+                     "(time arrived, process id, memory size, job time)\n",
+                     trace->filename, trace->line_number);
+            return -1;
+        }
+        reserve_rows(trace, 1);
+        for (field=0; field<NUM_FIELDS; field++) {
+            trace->columns[field][trace->count] = fields[field];
+        }
+        trace->count++;
+    }
+    trace->chunk_used -= cursor - trace->chunk;
+    memmove(trace->chunk, cursor, trace->chunk_used);
+    return 1;
+}
+
+/* Reads the next rows of a streamed binary trace, returns 0 once the file is
+   exhausted and -1 if it can't be read, with the reason in trace->failure */
+static int read_binary(Trace *trace) {
+    int field;
+    long rows = trace->binary_count - trace->binary_next;
+    size_t done;
+    ssize_t result;
+    off_t offset;
+    char *into;
+
+    if (rows == 0) {
+        return 0;
+    }
+    if (rows > STREAM_ROWS) {
+        rows = STREAM_ROWS;
+    }
+    reserve_rows(trace, rows);
+    for (field=0; field<NUM_FIELDS; field++) {
+        into = (char*)(trace->columns[field] + trace->count);
+        offset = trace->header_size +
+                 (field*trace->binary_count + trace->binary_next)*sizeof(int32_t);
+        for (done=0; done < rows*sizeof(int32_t); done += result) {
+            result = pread(trace->fd, into + done, rows*sizeof(int32_t) - done, offset + done);
+            if ((result < 0) && (errno == EINTR)) {
+                result = 0;
+                continue;
+            }
+            if (result <= 0) {
+                snprintf(trace->failure, FAILURE_LEN, "%s: unsupported or truncated binary trace\n",
+                         trace->filename);
+                return -1;
+            }
+        }
+    }
+    trace->count += rows;
+    trace->binary_next += rows;
+    return 1;
+}
+
+/* Reads more of a streamed trace until another process may arrive or the file
+   ends. Returns -1 if it can't be read, with the reason in trace->failure */
+static int read_more(Trace *trace) {
+    int old_ready, last, result;
+    int32_t *arrival_time;
+
+    while ((trace->next == trace->ready) && (trace->fd >= 0)) {
+        compact(trace);
+        old_ready = trace->ready;
+        result = trace->binary ? read_binary(trace) : read_text(trace);
+        if (result < 0) {
+            return -1;
+        }
+        if (result == 0) {
+            if (trace->fd != STDIN_FILENO) {
+                close(trace->fd);
+            }
+            trace->fd = -1;
+            trace->ready = trace->count;
+        } else if (trace->count > 0) {
+            // The last same-time group may carry on in what is yet to be read
+            arrival_time = trace->columns[ARRIVED];
+            last = trace->count;
+            while ((last > old_ready) && (arrival_time[last-1] == arrival_time[trace->count-1])) {
+                last--;
+            }
+            trace->ready = last;
+        }
+        order_rows(trace, old_ready, trace->ready);
+    }
+    return 0;
+}
+
+// Takes batches from the reader thread until another process may arrive or the trace ends
+static void take_batches(Trace *trace) {
+    int field;
+    ReadAhead *ahead = trace->ahead;
+    Batch *batch;
+
+    while ((trace->next == trace->ready) && (!ahead->ended)) {
+        pthread_mutex_lock(&ahead->lock);
+        while (ahead->filled == 0) {
+            pthread_cond_wait(&ahead->changed, &ahead->lock);
+        }
+        pthread_mutex_unlock(&ahead->lock);
+
+        // The rows before a failure have all been run by now, as when reading inline
+        batch = &ahead->batches[ahead->taken];
+        if (batch->failed) {
+            fprintf(stderr, "%s", ahead->source->failure);
+            exit(1);
+        }
+        compact(trace);
+        reserve_rows(trace, batch->count);
+        for (field=0; (field<NUM_FIELDS) && (batch->count > 0); field++) {
+            memcpy(trace->columns[field] + trace->count,
+                   batch->owned + (size_t)field*batch->capacity, batch->count*sizeof(int32_t));
+        }
+        trace->count += batch->count;
+        trace->ready = trace->count;
+        ahead->ended = batch->last;
+
+        pthread_mutex_lock(&ahead->lock);
+        ahead->taken = (ahead->taken + 1) % READ_AHEAD_BATCHES;
+        ahead->filled -= 1;
+        pthread_cond_broadcast(&ahead->changed);
+        pthread_mutex_unlock(&ahead->lock);
+    }
+}
+
+// Reads more of a streamed trace, or takes what the reader thread read, until another process may arrive
+static void refill(Trace *trace) {
+    if (trace->ahead != NULL) {
+        take_batches(trace);
+    } else if (read_more(trace) < 0) {
+        fprintf(stderr, "%s", trace->failure);
+        exit(1);
+    }
+}
+
+// Reads the source trace into batches, one per refill, for as long as the simulation takes them
+static void *read_batches(void *arg) {
+    int field, rows, failed, stopping;
+    ReadAhead *ahead = (ReadAhead*)arg;
+    Trace *source = ahead->source;
+    Batch *batch;
+    int slot = 0, last = 0;
+
+    do {
+        failed = (read_more(source) < 0);
+        rows = source->ready - source->next;
+
+        pthread_mutex_lock(&ahead->lock);
+        while ((ahead->filled == READ_AHEAD_BATCHES) && (!ahead->stopping)) {
+            pthread_cond_wait(&ahead->changed, &ahead->lock);
+        }
+        stopping = ahead->stopping;
+        pthread_mutex_unlock(&ahead->lock);
+        if (stopping) {
+            break;
+        }
+
+        // Slots are only reused once the simulation has copied them out
+        batch = &ahead->batches[slot];
+        if (rows > batch->capacity) {
+            free(batch->owned);
+            batch->capacity = rows;
+            batch->owned = (int32_t*)malloc((size_t)NUM_FIELDS*rows*sizeof(int32_t));
+            if (batch->owned == NULL) {
+                fprintf(stderr, "Out of memory buffering %s\n", source->filename);
+                exit(1);
+            }
+        }
+        for (field=0; (field<NUM_FIELDS) && (rows > 0); field++) {
+            memcpy(batch->owned + (size_t)field*batch->capacity,
+                   source->columns[field] + source->next, rows*sizeof(int32_t));
+        }
+        batch->count = rows;
+        batch->failed = failed;
+        batch->last = failed || (source->fd < 0);
+        last = batch->last;
+        source->next = source->ready;
+        slot = (slot + 1) % READ_AHEAD_BATCHES;
+
+        pthread_mutex_lock(&ahead->lock);
+        ahead->filled += 1;
+        pthread_cond_broadcast(&ahead->changed);
+        pthread_mutex_unlock(&ahead->lock);
+    } while (!last);
+    return NULL;
+}
+
+// Moves the reading of a streamed trace onto a thread that stays ahead of the simulation
+void read_ahead(Trace *trace) {
+    ReadAhead *ahead = (ReadAhead*)calloc(1, sizeof(ReadAhead));
+    Trace *source = (Trace*)calloc(1, sizeof(Trace));
+
+    // The file and anything read of it so far go with the reader
+    source->filename = trace->filename;
+    source->arena = trace->arena;
+    source->fd = trace->fd;
+    source->chunk = trace->chunk;
+    source->chunk_used = trace->chunk_used;
+    source->chunk_size = trace->chunk_size;
+    source->binary = trace->binary;
+    source->header_size = trace->header_size;
+    source->binary_count = trace->binary_count;
+    trace->fd = -1;
+    trace->chunk = NULL;
+
+    ahead->source = source;
+    pthread_mutex_init(&ahead->lock, NULL);
+    pthread_cond_init(&ahead->changed, NULL);
+    if (pthread_create(&ahead->reader, NULL, read_batches, ahead)) {
+        fprintf(stderr, "Failed to start the trace reader thread\n");
+        exit(1);
+    }
+    trace->ahead = ahead;
+}
+
+// Opens a text or binary trace to be read as processes arrive, "-" reads a text trace from stdin
+Trace *stream_trace(char *filename, Arena *arena) {
+    TraceHeader header;
+    struct stat file_stat;
+    long got;
+    Trace *trace = (Trace*)calloc(1, sizeof(Trace));
+
+    trace->arena = arena;
+    trace->filename = filename;
+    trace->fd = (!strcmp(filename, "-")) ? STDIN_FILENO : open(filename, O_RDONLY);
+    if ((trace->fd < 0) || (fstat(trace->fd, &file_stat) < 0)) {
+        fprintf(stderr, "Could not open %s: %s\n", filename, strerror(errno));
+        exit(1);
+    }
+    trace->chunk_size = STREAM_CHUNK;
+    trace->chunk = (char*)malloc(trace->chunk_size);
+
+    // Whatever isn't a binary header is the start of the text
+    got = read_fully(trace, trace->chunk, sizeof(TraceHeader));
+    if (got < 0) {
+        fprintf(stderr, "%s", trace->failure);
+        exit(1);
+    }
+    trace->chunk_used = got;
+    if ((trace->chunk_used >= TRACE_MAGIC_LEN) &&
+        (!memcmp(trace->chunk, TRACE_MAGIC, TRACE_MAGIC_LEN))) {
+        memcpy(&header, trace->chunk, sizeof(TraceHeader));
+        if ((trace->chunk_used < sizeof(TraceHeader)) || (!S_ISREG(file_stat.st_mode)) ||
+            (header.version != TRACE_VERSION) || (header.header_size < sizeof(TraceHeader)) ||
+            (header.header_size + NUM_FIELDS*header.count*sizeof(int32_t) >
+             (uint64_t)file_stat.st_size)) {
+            fprintf(stderr, "%s: unsupported or truncated binary trace\n", filename);
+            exit(1);
+        }
+        trace->binary = 1;
+        trace->header_size = header.header_size;
+        trace->binary_count = header.count;
+        trace->chunk_used = 0;
+    }
+    return trace;
+}
+
+// Returns a new cursor over the same processes, starting from the first, with records from arena
+Trace *view_trace(Trace *trace, Arena *arena) {
+    Trace *view = (Trace*)malloc(sizeof(Trace));
+
+    *view = *trace;
+    view->next = 0;
+    view->arena = arena;
+    // The columns stay with the original trace
+    view->mapping = NULL;
+    view->owned = NULL;
+    view->released = NULL;
+    return view;
+}
+
+// Writes a trace out in the binary format
+void write_trace(Trace *trace, char *filename) {
+    int field;
+    TraceHeader header;
+    FILE *output = fopen(filename, "wb");
+
+    if (output == NULL) {
+        fprintf(stderr, "Could not open %s: %s\n", filename, strerror(errno));
+        exit(1);
+    }
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_MAGIC, TRACE_MAGIC_LEN);
+    header.version = TRACE_VERSION;
+    header.header_size = sizeof(header);
+    header.count = trace->count;
+    header.flags = TRACE_ORDERED;
+
+    fwrite(&header, sizeof(header), 1, output);
+    for (field=0; field<NUM_FIELDS; field++) {
+        fwrite(trace->columns[field], sizeof(int32_t), trace->count, output);
+    }
+    if (fclose(output) != 0) {
+        fprintf(stderr, "Could not write %s: %s\n", filename, strerror(errno));
+        exit(1);
+    }
+}
+
+// Free the memory associated with a Trace, arrived processes belong to its Arena
+void free_trace(Trace *trace) {
+    int i;
+    ReadAhead *ahead = trace->ahead;
+
+    // A reader still going is stopped before its batches go
+    if (ahead != NULL) {
+        pthread_mutex_lock(&ahead->lock);
+        ahead->stopping = 1;
+        pthread_cond_broadcast(&ahead->changed);
+        pthread_mutex_unlock(&ahead->lock);
+        pthread_join(ahead->reader, NULL);
+        for (i=0; i<READ_AHEAD_BATCHES; i++) {
+            free(ahead->batches[i].owned);
+        }
+        pthread_cond_destroy(&ahead->changed);
+        pthread_mutex_destroy(&ahead->lock);
+        free_trace(ahead->source);
+        free(ahead);
+    }
+    if (trace->mapping != NULL) {
+        munmap(trace->mapping, trace->mapping_size);
+    }
+    if ((trace->fd >= 0) && (trace->fd != STDIN_FILENO)) {
+        close(trace->fd);
+    }
+    free(trace->chunk);
+    free(trace->owned);
+    free(trace);
+}
+
+// Checks whether every process in the trace has arrived
+int trace_done(Trace *trace) {
+    if (trace->next == trace->ready) {
+        refill(trace);
+    }
+    return (trace->next == trace->count) ? 1 : 0;
+}
+
+// Hands a finished process back so its record can be reused
+void release_process(Trace *trace, Process *process) {
+    process->next_resident = trace->released;
+    trace->released = process;
+}
+
+// Returns a record for a process, reusing a released one if there is one
+Process *new_process(Trace *trace) {
+    Process *process = trace->released;
+
+    // Reused records keep their page list
+    if (process != NULL) {
+        trace->released = process->next_resident;
+    } else {
+        process = (Process*)arena_alloc(trace->arena, sizeof(Process));
+        process->mem_index = NULL;
+        process->mem_capacity = 0;
+    }
+    process->prev_resident = NULL;
+    process->next_resident = NULL;
+    return process;
+}
+
+// Turns the next process of the trace into a Process record
+static Process *materialise(Trace *trace) {
+    int i = trace->next;
+    Process *process = new_process(trace);
+
+    process->arrival_time = trace->columns[ARRIVED][i];
+    process->pid = trace->columns[ID][i];
+    process->mem_req = trace->columns[MEM_REQ][i]/KB_PER_PAGE;
+    process->job_time = trace->columns[JOB_TIME][i];
+    process->remaining_time = process->job_time;
+    // Page lists are only allocated once a process is first loaded
+    process->mem_start = 0;
+    process->pages_used = 0;
+    process->next_reference = 0;
+    process->arrival_order = trace->base + i;
+    trace->next++;
+    return process;
+}
+
+// Appends a process from process_list to arrived at the appropriate time
+void update_deque(int clock, Trace *process_list, Deque *arrived) {
+    PROFILE_START(PHASE_QUEUE);
+    while ((!trace_done(process_list)) &&
+           (process_list->columns[ARRIVED][process_list->next] <= clock)) {
+        deque_append(arrived, materialise(process_list));
+    }
+    PROFILE_STOP();
+    return;
+}
+
+// Returns the arrival time of the next process yet to arrive
+int next_arrival(Trace *process_list) {
+    if (process_list->next == process_list->ready) {
+        refill(process_list);
+    }
+    return process_list->columns[ARRIVED][process_list->next];
+}
@@ -0,0 +1,139 @@
+#ifndef TRACE_H
+#define TRACE_H
+#define ARRIVED 0
+#define ID 1
+#define MEM_REQ 2
+#define JOB_TIME 3
+#define NUM_FIELDS 4
+#define MAX_REPORTED 20
+#define MAX_DIGITS 10
+#define TRACE_MAGIC "SCHTRACE"
+#define TRACE_MAGIC_LEN 8
+#define TRACE_VERSION 1
+#define TRACE_ORDERED 1
+#define STREAM_CHUNK (1 << 16)
+#define STREAM_ROWS (1 << 13)
+#define READ_AHEAD_BATCHES 2
+#define FAILURE_LEN 320
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include "process-deque.h"
+#include "arena.h"
+
+typedef struct trace_header TraceHeader;
+typedef struct trace Trace;
+typedef struct batch Batch;
+typedef struct read_ahead ReadAhead;
+
+/* Binary trace layout: this header, then NUM_FIELDS int32 columns of count
+   entries each, in field order, starting header_size bytes into the file */
+struct trace_header {
+    char magic[TRACE_MAGIC_LEN];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t count;
+    uint32_t flags; // TRACE_ORDERED: same-time arrivals are already in pid order
+    uint32_t reserved;
+};
+
+/* Processes yet to arrive, kept as columns and only turned into Process records
+   on arrival. A streamed trace only buffers the columns of processes read but
+   not yet arrived, refilling them from its file as they run out */
+struct trace {
+    int count;
+    int next; // Index of the next process to arrive
+    int ready; // Processes before this one are ordered and may arrive
+    int32_t *columns[NUM_FIELDS];
+    void *mapping; // Binary traces are read in place from their mapping
+    size_t mapping_size;
+    int32_t *owned; // Column storage for traces that had to be parsed or reordered
+    int capacity; // Processes the owned columns of a streamed trace have room for
+    Arena *arena;
+    Process *released; // Finished processes kept for reuse
+    // Streaming state, fd is -1 once the file is fully read or if it never streamed
+    int fd;
+    char *filename;
+    long base; // Position in the whole trace of the first buffered process
+    char *chunk; // Text read but not yet parsed
+    size_t chunk_used;
+    size_t chunk_size;
+    long line_number;
+    int binary;
+    uint32_t header_size;
+    long binary_count;
+    long binary_next;
+    char failure[FAILURE_LEN]; // Why reading stopped, reported by whoever needs the rows
+    ReadAhead *ahead; // Set once a reader thread reads the trace instead
+};
+
+// Ordered rows handed from the reader thread to the simulation
+struct batch {
+    int32_t *owned; // NUM_FIELDS columns of capacity rows each
+    int count;
+    int capacity;
+    int last; // Nothing follows this batch
+    int failed; // Reading stopped at an error after the rows of this batch
+};
+
+/* Arrivals read ahead of the simulation. A reader thread parses and orders
+   the streamed trace while the simulation runs, one batch per refill, each
+   ending on a complete same-time group. The arrival time of the next batch is
+   never earlier than the end of the one before, so the simulation can run a
+   batch's processes as soon as it has them, and only waits on the reader
+   when it catches up with it */
+struct read_ahead {
+    Trace *source; // The reader's own cursor over the file
+    Batch batches[READ_AHEAD_BATCHES];
+    int taken; // Next batch the simulation takes
+    int filled; // Batches read and not yet taken
+    int ended; // The simulation has taken the last batch
+    int stopping; // Set to stop the reader early
+    pthread_t reader;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+};
+
+// Loads a text or binary trace, told apart by the magic number, with records coming from arena
+Trace *load_trace(char *filename, Arena *arena);
+
+// Opens a text or binary trace to be read as processes arrive, "-" reads a text trace from stdin
+Trace *stream_trace(char *filename, Arena *arena);
+
+// Moves the reading of a streamed trace onto a thread that stays ahead of the simulation
+void read_ahead(Trace *trace);
+
+// Returns a new cursor over the same processes, starting from the first, with records from arena
+Trace *view_trace(Trace *trace, Arena *arena);
+
+// Writes a trace out in the binary format
+void write_trace(Trace *trace, char *filename);
+
+// Free the memory associated with a Trace, arrived processes belong to its Arena
+void free_trace(Trace *trace);
+
+// Hands a finished process back so its record can be reused
+void release_process(Trace *trace, Process *process);
+
+// Returns a record for a process, reusing a released one if there is one
+Process *new_process(Trace *trace);
+
+// Checks whether every process in the trace has arrived
+int trace_done(Trace *trace);
+
+// Appends a process from process_list to arrived at the appropriate time
+void update_deque(int clock, Trace *process_list, Deque *arrived);
+
+// Returns the arrival time of the next process yet to arrive
+int next_arrival(Trace *process_list);
+
+#endif